@@ -0,0 +1,37 @@
+# - Try to find OSMesa (Mesa's offscreen rendering interface)
+# Once done this will define
+#
+#  OSMESA_FOUND        - system has OSMesa
+#  OSMESA_INCLUDE_DIR  - the GL/osmesa.h include directory
+#  OSMESA_LIBRARIES    - Link these to use OSMesa. They include the GL functions, don't link libGL too
+
+FIND_PATH(OSMESA_INCLUDE_DIR GL/osmesa.h
+  /usr/include
+  /usr/local/include
+  /opt/graphics/OpenGL/include
+)
+
+FIND_LIBRARY(OSMESA_LIBRARY
+  NAMES OSMesa OSMesa32 OSMesa16
+  PATHS /usr/lib
+        /usr/local/lib
+        /opt/graphics/OpenGL/lib
+)
+
+SET( OSMESA_FOUND "NO" )
+IF(OSMESA_INCLUDE_DIR AND OSMESA_LIBRARY)
+
+    SET( OSMESA_LIBRARIES ${OSMESA_LIBRARY} )
+
+    SET( OSMESA_FOUND "YES" )
+
+ENDIF(OSMESA_INCLUDE_DIR AND OSMESA_LIBRARY)
+
+IF(OSMesa_FIND_REQUIRED AND NOT OSMESA_FOUND)
+    MESSAGE(FATAL_ERROR "Could not find OSMesa")
+ENDIF()
+
+MARK_AS_ADVANCED(
+  OSMESA_INCLUDE_DIR
+  OSMESA_LIBRARY
+)
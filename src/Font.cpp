@@ -1,10 +1,15 @@
 #include "Font.h"
 #include <iostream>
 #include <algorithm>
+#include <math.h>
 #include <vector>
 #include "Renderer.h"
 #include <boost/filesystem.hpp>
 #include "Log.h"
+#include "Settings.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "MemoryStats.h"
 
 FT_Library Font::sLibrary;
 bool Font::libraryInitialized = false;
@@ -15,6 +20,7 @@ int Font::getDpiY() { return 96; }
 int Font::getSize() const { return mSize; }
 
 std::map< std::pair<std::string, int>, std::weak_ptr<Font> > Font::sFontMap;
+std::map< std::string, std::weak_ptr<Font> > Font::sSdfFaceMap;
 
 std::string Font::getDefaultPath()
 {
@@ -71,11 +77,16 @@ void Font::initLibrary()
 	}
 }
 
-Font::Font(const ResourceManager& rm, const std::string& path, int size) : fontScale(1.0f), mSize(size), mPath(path)
+Font::Font(const ResourceManager& rm, const std::string& path, int size, bool sdf) : textureID(0), fontScale(1.0f), mSize(size), mPath(path), mSdf(sdf)
 {
 	reload(rm);
 }
 
+Font::Font(std::shared_ptr<Font> sdfFace, int size) : textureID(0), mMaxGlyphHeight(0), fontScale((float)size / sdfFace->mSize), mSize(size), mPath(sdfFace->mPath), 
+	mSdf(false), mSdfFace(sdfFace)
+{
+}
+
 Font::~Font()
 {
 	LOG(LogInfo) << "Destroying font \"" << mPath << "\" with size " << mSize << ".";
@@ -84,6 +95,10 @@ Font::~Font()
 
 void Font::reload(const ResourceManager& rm)
 {
+	//fonts drawing with a shared SDF face have nothing to load themselves
+	if(mSdfFace)
+		return;
+
 	init(rm.getFileData(mPath));
 }
 
@@ -108,12 +123,37 @@ std::shared_ptr<Font> Font::get(ResourceManager& rm, const std::string& path, in
 			return foundFont->second.lock();
 	}
 
-	std::shared_ptr<Font> font = std::shared_ptr<Font>(new Font(rm, path, size));
+	std::shared_ptr<Font> font;
+	if(Settings::getInstance()->getBool("SDFFONTS"))
+	{
+		//every size of a face draws from the same distance field atlas
+		std::shared_ptr<Font> face;
+		auto foundFace = sSdfFaceMap.find(path);
+		if(foundFace != sSdfFaceMap.end())
+			face = foundFace->second.lock();
+
+		if(!face)
+		{
+			face = std::shared_ptr<Font>(new Font(rm, path, SDF_BASE_SIZE, true));
+			sSdfFaceMap[path] = std::weak_ptr<Font>(face);
+			rm.addReloadable(face);
+		}
+
+		font = std::shared_ptr<Font>(new Font(face, size));
+	}else{
+		font = std::shared_ptr<Font>(new Font(rm, path, size));
+		rm.addReloadable(font);
+	}
+
 	sFontMap[def] = std::weak_ptr<Font>(font);
-	rm.addReloadable(font);
 	return font;
 }
 
+const Font* Font::getAtlasFont() const
+{
+	return mSdfFace ? mSdfFace.get() : this;
+}
+
 void Font::init(ResourceData data)
 {
 	if(!libraryInitialized)
@@ -121,20 +161,25 @@ void Font::init(ResourceData data)
 
 	mMaxGlyphHeight = 0;
 
-	buildAtlas(data);
+	if(mSdf)
+		buildSdfAtlas(data);
+	else
+		buildAtlas(data);
 }
 
 void Font::deinit()
 {
 	if(textureID)
 	{
-		glDeleteTextures(1, &textureID);
+		Renderer::deleteTexture(textureID);
+		MemoryStats::remove(MemoryStats::CATEGORY_FONTS, textureWidth * textureHeight);
 		textureID = 0;
 	}
 }
 
 void Font::buildAtlas(ResourceData data)
 {
+	TraceScope trace("Font::buildAtlas", mPath + " " + std::to_string((long long)mSize));
 	if(FT_New_Memory_Face(sLibrary, data.ptr.get(), data.length, 0, &face))
 	{
 		LOG(LogError) << "Error creating font face!";
@@ -170,7 +215,7 @@ void Font::buildAtlas(ResourceData data)
 
 	//create the texture
 	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	Renderer::bindTexture(textureID);
 
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -182,6 +227,7 @@ void Font::buildAtlas(ResourceData data)
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, w, h, 0, GL_ALPHA, GL_UNSIGNED_BYTE, NULL);
+	MemoryStats::add(MemoryStats::CATEGORY_FONTS, textureWidth * textureHeight);
 
 	//copy the glyphs into the texture
 	int x = 0;
@@ -217,6 +263,7 @@ void Font::buildAtlas(ResourceData data)
 		if(g->bitmap.rows > maxHeight)
 			maxHeight = g->bitmap.rows;
 
+		Profiler::count(Profiler::COUNTER_TEXTURE_UPLOADS);
 		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, g->bitmap.width, g->bitmap.rows, GL_ALPHA, GL_UNSIGNED_BYTE, g->bitmap.buffer);
 
 
@@ -235,8 +282,6 @@ void Font::buildAtlas(ResourceData data)
 		x += g->bitmap.width + 1; //leave one pixel of space between glyphs
 	}
 
-	glBindTexture(GL_TEXTURE_2D, 0);
-
 	FT_Done_Face(face);
 
 	if((y + maxHeight) >= textureHeight)
@@ -253,6 +298,190 @@ void Font::buildAtlas(ResourceData data)
 	}
 }
 
+//8-point sequential signed euclidean distance transform, see http://www.codersnotes.com/notes/signed-distance-fields/
+//every cell stores the offset to the closest "set" cell, the passes propagate those offsets over the grid.
+struct SdfCell
+{
+	int dx, dy;
+	int distSq() const { return dx * dx + dy * dy; }
+};
+
+static const SdfCell SDF_CELL_EMPTY = { 9999, 9999 };
+
+static void sdfCompare(const std::vector<SdfCell>& grid, int w, int h, SdfCell& cell, int x, int y, int offsetX, int offsetY)
+{
+	x += offsetX;
+	y += offsetY;
+
+	SdfCell other = (x >= 0 && y >= 0 && x < w && y < h) ? grid[y * w + x] : SDF_CELL_EMPTY;
+	other.dx += offsetX;
+	other.dy += offsetY;
+
+	if(other.distSq() < cell.distSq())
+		cell = other;
+}
+
+static void sdfPropagate(std::vector<SdfCell>& grid, int w, int h)
+{
+	for(int y = 0; y < h; y++)
+	{
+		for(int x = 0; x < w; x++)
+		{
+			SdfCell& cell = grid[y * w + x];
+			sdfCompare(grid, w, h, cell, x, y, -1, 0);
+			sdfCompare(grid, w, h, cell, x, y, 0, -1);
+			sdfCompare(grid, w, h, cell, x, y, -1, -1);
+			sdfCompare(grid, w, h, cell, x, y, 1, -1);
+		}
+
+		for(int x = w - 1; x >= 0; x--)
+			sdfCompare(grid, w, h, grid[y * w + x], x, y, 1, 0);
+	}
+
+	for(int y = h - 1; y >= 0; y--)
+	{
+		for(int x = w - 1; x >= 0; x--)
+		{
+			SdfCell& cell = grid[y * w + x];
+			sdfCompare(grid, w, h, cell, x, y, 1, 0);
+			sdfCompare(grid, w, h, cell, x, y, 0, 1);
+			sdfCompare(grid, w, h, cell, x, y, -1, 1);
+			sdfCompare(grid, w, h, cell, x, y, 1, 1);
+		}
+
+		for(int x = 0; x < w; x++)
+			sdfCompare(grid, w, h, grid[y * w + x], x, y, -1, 0);
+	}
+}
+
+void Font::buildSdfAtlas(ResourceData data)
+{
+	TraceScope trace("Font::buildSdfAtlas", mPath);
+	if(FT_New_Memory_Face(sLibrary, data.ptr.get(), data.length, 0, &face))
+	{
+		LOG(LogError) << "Error creating font face!";
+		return;
+	}
+
+	//glyphs are rendered SDF_SUPERSAMPLE times larger than they are stored so the distances are accurate to a fraction of a texel
+	const int ss = SDF_SUPERSAMPLE;
+	const int pad = SDF_SPREAD * ss;
+	FT_Set_Pixel_Sizes(face, 0, mSize * ss);
+	FT_GlyphSlot g = face->glyph;
+
+	textureWidth = 1024;
+	textureHeight = 512;
+
+	glGenTextures(1, &textureID);
+	Renderer::bindTexture(textureID);
+
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	//the field interpolates, so unlike the bitmap atlas this one is filtered
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, textureWidth, textureHeight, 0, GL_ALPHA, GL_UNSIGNED_BYTE, NULL);
+	MemoryStats::add(MemoryStats::CATEGORY_FONTS, textureWidth * textureHeight);
+
+	std::vector<SdfCell> inside, outside;
+	std::vector<unsigned char> field;
+
+	int x = 0;
+	int y = 0;
+	int maxHeight = 0;
+	for(int i = 32; i < 128; i++)
+	{
+		if(FT_Load_Char(face, i, FT_LOAD_RENDER))
+			continue;
+
+		//size of the supersampled glyph including the padding the field spreads into, rounded up to whole texels
+		const int hw = ((g->bitmap.width + pad * 2 + ss - 1) / ss) * ss;
+		const int hh = ((g->bitmap.rows + pad * 2 + ss - 1) / ss) * ss;
+		const int w = hw / ss;
+		const int h = hh / ss;
+
+		inside.assign(hw * hh, SDF_CELL_EMPTY);
+		outside.assign(hw * hh, SDF_CELL_EMPTY);
+		const SdfCell zero = { 0, 0 };
+		for(int by = 0; by < hh; by++)
+		{
+			for(int bx = 0; bx < hw; bx++)
+			{
+				const int gx = bx - pad;
+				const int gy = by - pad;
+				const bool set = gx >= 0 && gy >= 0 && gx < g->bitmap.width && gy < g->bitmap.rows && g->bitmap.buffer[gy * g->bitmap.pitch + gx] >= 128;
+				if(set)
+					inside[by * hw + bx] = zero;
+				else
+					outside[by * hw + bx] = zero;
+			}
+		}
+
+		sdfPropagate(inside, hw, hh);
+		sdfPropagate(outside, hw, hh);
+
+		//sample the center of every texel. 0.5 is the glyph outline, larger values are inside the glyph.
+		field.resize(w * h);
+		for(int ty = 0; ty < h; ty++)
+		{
+			for(int tx = 0; tx < w; tx++)
+			{
+				const int idx = (ty * ss + ss / 2) * hw + (tx * ss + ss / 2);
+				const float dist = (sqrtf((float)inside[idx].distSq()) - sqrtf((float)outside[idx].distSq())) / ss;
+				float value = 0.5f - dist / (2.0f * SDF_SPREAD);
+				if(value < 0.0f)
+					value = 0.0f;
+				else if(value > 1.0f)
+					value = 1.0f;
+				field[ty * w + tx] = (unsigned char)(value * 255);
+			}
+		}
+
+		if(x + w >= textureWidth)
+		{
+			x = 0;
+			y += maxHeight + 1; //leave one pixel of space between glyphs
+			maxHeight = 0;
+		}
+
+		if(h > maxHeight)
+			maxHeight = h;
+
+		if(y + h < textureHeight)
+		{
+			Profiler::count(Profiler::COUNTER_TEXTURE_UPLOADS);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_ALPHA, GL_UNSIGNED_BYTE, field.data());
+		}
+
+		//metrics are stored at mSize, the padding moves the glyph origin
+		charData[i].texX = x;
+		charData[i].texY = y;
+		charData[i].texW = w;
+		charData[i].texH = h;
+		charData[i].advX = (float)g->metrics.horiAdvance / 64.0f / ss;
+		charData[i].advY = (float)g->metrics.vertAdvance / 64.0f / ss;
+		charData[i].bearingX = (float)g->metrics.horiBearingX / 64.0f / ss - (float)pad / ss;
+		charData[i].bearingY = (float)g->metrics.horiBearingY / 64.0f / ss + (float)pad / ss;
+
+		if(g->bitmap.rows / ss > mMaxGlyphHeight)
+			mMaxGlyphHeight = g->bitmap.rows / ss;
+
+		x += w + 1; //leave one pixel of space between glyphs
+	}
+
+	FT_Done_Face(face);
+
+	if((y + maxHeight) >= textureHeight)
+		LOG(LogError) << "Distance field for font \"" << mPath << "\" exceeded the atlas size! Some glyphs will be missing.";
+	else
+		LOG(LogInfo) << "Created distance field font \"" << mPath << "\". textureID: " << textureID;
+}
+
 
 void Font::drawText(std::string text, const Eigen::Vector2f& offset, unsigned int color)
 {
@@ -263,7 +492,9 @@ void Font::drawText(std::string text, const Eigen::Vector2f& offset, unsigned in
 
 void Font::renderTextCache(TextCache* cache)
 {
-	if(!textureID)
+	const Font* atlas = getAtlasFont();
+
+	if(!atlas->textureID)
 	{
 		LOG(LogError) << "Error - tried to draw with Font that has no texture loaded!";
 		return;
@@ -281,31 +512,20 @@ void Font::renderTextCache(TextCache* cache)
 		return;
 	}
 
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-	glEnableClientState(GL_COLOR_ARRAY);
-
-	glVertexPointer(2, GL_FLOAT, sizeof(TextCache::Vertex), &cache->verts[0].pos);
-	glTexCoordPointer(2, GL_FLOAT, sizeof(TextCache::Vertex), &cache->verts[0].tex);
-	glColorPointer(4, GL_UNSIGNED_BYTE, 0, cache->colors);
-
-	glDrawArrays(GL_TRIANGLES, 0, cache->vertCount);
+	if(cache->vertCount == 0)
+		return;
 
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-	glDisableClientState(GL_COLOR_ARRAY);
+	//cut distance field glyphs at their outline (0.5), scaled by the text alpha so fading still works.
+	//the field itself isn't coverage, see Renderer::drawVertices() for how it's turned into solid glyphs
+	const float alphaCutoff = atlas->mSdf ? 0.5f * (cache->verts[0].color[3] / 255.0f) : 0.0f;
 
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_BLEND);
+	Renderer::drawTextVertices(atlas->textureID, cache->verts, cache->vertCount, alphaCutoff);
 }
 
 Eigen::Vector2f Font::sizeText(std::string text) const
 {
+	const Font* atlas = getAtlasFont();
+
 	float cwidth = 0.0f;
 	for(unsigned int i = 0; i < text.length(); i++)
 	{
@@ -313,7 +533,7 @@ Eigen::Vector2f Font::sizeText(std::string text) const
 		if(letter < 32 || letter >= 128)
 			letter = 127;
 
-		cwidth += charData[letter].advX * fontScale;
+		cwidth += atlas->charData[letter].advX * fontScale;
 	}
 
 	return Eigen::Vector2f(cwidth, getHeight());
@@ -321,7 +541,7 @@ Eigen::Vector2f Font::sizeText(std::string text) const
 
 int Font::getHeight() const
 {
-	return (int)(mMaxGlyphHeight * 1.5f * fontScale);
+	return (int)(getAtlasFont()->mMaxGlyphHeight * 1.5f * fontScale);
 }
 
 
@@ -471,7 +691,10 @@ Eigen::Vector2f Font::sizeWrappedText(std::string text, float xLen) const
 
 TextCache* Font::buildTextCache(const std::string& text, float offsetX, float offsetY, unsigned int color)
 {
-	if(!textureID)
+	const Font* atlas = getAtlasFont();
+	const charPosData* charData = atlas->charData;
+
+	if(!atlas->textureID)
 	{
 		LOG(LogError) << "Error - tried to build TextCache with Font that has no texture loaded!";
 		return NULL;
@@ -479,15 +702,14 @@ TextCache* Font::buildTextCache(const std::string& text, float offsetX, float of
 
 	const int triCount = text.length() * 2;
 	const int vertCount = triCount * 3;
-	TextCache::Vertex* vert = new TextCache::Vertex[vertCount];
-	GLubyte* colors = new GLubyte[vertCount * 4];
+	Renderer::Vertex* vert = new Renderer::Vertex[vertCount];
 
 	//texture atlas width/height
-	float tw = (float)textureWidth;
-	float th = (float)textureHeight;
+	float tw = (float)atlas->textureWidth;
+	float th = (float)atlas->textureHeight;
 
 	float x = offsetX;
-	float y = offsetY + mMaxGlyphHeight * 1.1f * fontScale; //padding (another 0.5% is added to the bottom through the sizeText function)
+	float y = offsetY + atlas->mMaxGlyphHeight * 1.1f * fontScale; //padding (another 0.5% is added to the bottom through the sizeText function)
 
 	int charNum = 0;
 	for(int i = 0; i < vertCount; i += 6, charNum++)
@@ -499,50 +721,50 @@ TextCache* Font::buildTextCache(const std::string& text, float offsetX, float of
 
 		//the glyph might not start at the cursor position, but needs to be shifted a bit
 		const float glyphStartX = x + charData[letter].bearingX * fontScale;
-		//order is bottom left, top right, top left
-		vert[i + 0].pos << glyphStartX, y + (charData[letter].texH - charData[letter].bearingY) * fontScale;
-		vert[i + 1].pos << glyphStartX + charData[letter].texW * fontScale, y - charData[letter].bearingY * fontScale;
-		vert[i + 2].pos << glyphStartX, vert[i + 1].pos.y();
-
-		Eigen::Vector2i charTexCoord(charData[letter].texX, charData[letter].texY);
-		Eigen::Vector2i charTexSize(charData[letter].texW, charData[letter].texH);
-
-		vert[i + 0].tex << charTexCoord.x() / tw, (charTexCoord.y() + charTexSize.y()) / th;
-		vert[i + 1].tex << (charTexCoord.x() + charTexSize.x()) / tw, charTexCoord.y() / th;
-		vert[i + 2].tex << vert[i + 0].tex.x(), vert[i + 1].tex.y();
-
-		//next triangle (second half of the quad)
-		vert[i + 3].pos = vert[i + 0].pos;
-		vert[i + 4].pos = vert[i + 1].pos;
-		vert[i + 5].pos[0] = vert[i + 1].pos.x();
-		vert[i + 5].pos[1] = vert[i + 0].pos.y();
-
-		vert[i + 3].tex = vert[i + 0].tex;
-		vert[i + 4].tex = vert[i + 1].tex;
-		vert[i + 5].tex[0] = vert[i + 1].tex.x();
-		vert[i + 5].tex[1] = vert[i + 0].tex.y();
+		const float left = glyphStartX;
+		const float right = glyphStartX + charData[letter].texW * fontScale;
+		const float bottom = y + (charData[letter].texH - charData[letter].bearingY) * fontScale;
+		const float top = y - charData[letter].bearingY * fontScale;
+
+		const float texLeft = charData[letter].texX / tw;
+		const float texRight = (charData[letter].texX + charData[letter].texW) / tw;
+		const float texBottom = (charData[letter].texY + charData[letter].texH) / th;
+		const float texTop = charData[letter].texY / th;
+
+		//order is bottom left, top right, top left, then bottom left, top right, bottom right for the second half of the quad
+		const float corners[6][4] = {
+			{ left, bottom, texLeft, texBottom }, { right, top, texRight, texTop }, { left, top, texLeft, texTop },
+			{ left, bottom, texLeft, texBottom }, { right, top, texRight, texTop }, { right, bottom, texRight, texBottom }
+		};
+
+		for(int v = 0; v < 6; v++)
+		{
+			vert[i + v].pos[0] = corners[v][0];
+			vert[i + v].pos[1] = corners[v][1];
+			vert[i + v].tex[0] = corners[v][2];
+			vert[i + v].tex[1] = corners[v][3];
+		}
 
 		x += charData[letter].advX * fontScale;
 	}
 
-	TextCache* cache = new TextCache(vertCount, vert, colors, this);
-	if(color != 0x00000000)
-		cache->setColor(color);
+	TextCache* cache = new TextCache(vertCount, vert, this);
+	cache->setColor(color);
 
 	return cache;
 }
 
-TextCache::TextCache(int verts, Vertex* v, GLubyte* c, Font* f) : vertCount(verts), verts(v), colors(c), sourceFont(f)
+TextCache::TextCache(int verts, Renderer::Vertex* v, Font* f) : vertCount(verts), verts(v), sourceFont(f)
 {
 }
 
 TextCache::~TextCache()
 {
 	delete[] verts;
-	delete[] colors;
 }
 
 void TextCache::setColor(unsigned int color)
 {
-	Renderer::buildGLColorArray(const_cast<GLubyte*>(colors), color, vertCount);
+	for(int i = 0; i < vertCount; i++)
+		Renderer::buildGLColorArray(verts[i].color, color, 1);
 }
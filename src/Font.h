@@ -8,6 +8,7 @@
 #include FT_FREETYPE_H
 #include <Eigen/Dense>
 #include "resources/ResourceManager.h"
+#include "Renderer.h"
 
 class TextCache;
 
@@ -15,6 +16,12 @@ class TextCache;
 #define FONT_SIZE_MEDIUM ((unsigned int)(0.045f * Renderer::getScreenHeight()))
 #define FONT_SIZE_LARGE ((unsigned int)(0.1f * Renderer::getScreenHeight()))
 
+//signed distance field fonts (enabled with the SDFFONTS setting) render every face only once at this size
+//and scale the glyphs for all other sizes. SDF_SPREAD is the distance in texels encoded in the field.
+#define SDF_BASE_SIZE 48
+#define SDF_SPREAD 4
+#define SDF_SUPERSAMPLE 4
+
 //A TrueType Font renderer that uses FreeType and OpenGL.
 //The library is automatically initialized when it's needed.
 class Font : public IReloadable
@@ -74,13 +81,18 @@ private:
 	static bool libraryInitialized;
 
 	static std::map< std::pair<std::string, int>, std::weak_ptr<Font> > sFontMap;
+	static std::map< std::string, std::weak_ptr<Font> > sSdfFaceMap; //distance field atlases, one per font file
 
-	Font(const ResourceManager& rm, const std::string& path, int size);
+	Font(const ResourceManager& rm, const std::string& path, int size, bool sdf = false);
+	Font(std::shared_ptr<Font> sdfFace, int size); //a font that draws with the atlas of sdfFace, scaled to size
 
 	void init(ResourceData data);
 	void deinit();
 
 	void buildAtlas(ResourceData data); //Builds a "texture atlas," one big OpenGL texture with glyphs 32 to 128.
+	void buildSdfAtlas(ResourceData data); //Same, but stores a signed distance field of every glyph so the atlas can be drawn at any scale.
+
+	const Font* getAtlasFont() const; //The font that owns the glyph texture and charData used for drawing (this, or the shared SDF face).
 
 	int textureWidth; //OpenGL texture width
 	int textureHeight; //OpenGL texture height
@@ -89,25 +101,21 @@ private:
 
 	int mSize;
 	const std::string mPath;
+
+	bool mSdf; //this font owns a distance field atlas
+	std::shared_ptr<Font> mSdfFace; //if set, this font draws with the distance field atlas of mSdfFace
 };
 
 class TextCache
 {
 public:
-	struct Vertex
-	{
-		Eigen::Vector2f pos;
-		Eigen::Vector2f tex;
-	};
-
 	void setColor(unsigned int color);
 
-	TextCache(int verts, Vertex* v, GLubyte* c, Font* f);
+	TextCache(int verts, Renderer::Vertex* v, Font* f);
 	~TextCache();
 
 	const int vertCount;
-	const Vertex* verts;
-	const GLubyte* colors;
+	Renderer::Vertex* const verts; //two triangles per character, ready for Renderer::uploadVertices
 	const Font* sourceFont;
 };
 
@@ -0,0 +1,54 @@
+#include "FrameTimeStats.h"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+void FrameTimeStats::add(float ms)
+{
+	mTimes.push_back(ms);
+}
+
+unsigned int FrameTimeStats::getCount() const
+{
+	return mTimes.size();
+}
+
+float FrameTimeStats::getPercentile(float percent) const
+{
+	if(mTimes.empty())
+		return 0;
+
+	if(mSorted.size() != mTimes.size())
+	{
+		mSorted = mTimes;
+		std::sort(mSorted.begin(), mSorted.end());
+	}
+
+	//nearest rank
+	int index = (int)ceil(percent / 100.0f * mSorted.size()) - 1;
+	if(index < 0)
+		index = 0;
+	if(index >= (int)mSorted.size())
+		index = mSorted.size() - 1;
+	return mSorted.at(index);
+}
+
+std::string FrameTimeStats::getSummary() const
+{
+	if(mTimes.empty())
+		return "no frames";
+
+	double total = 0;
+	for(unsigned int i = 0; i < mTimes.size(); i++)
+		total += mTimes.at(i);
+
+	std::stringstream ss;
+	ss << mTimes.size() << " frames" << std::fixed << std::setprecision(2)
+		<< ", mean " << total / mTimes.size() << "ms"
+		<< ", median " << getPercentile(50) << "ms"
+		<< ", 90% " << getPercentile(90) << "ms"
+		<< ", 99% " << getPercentile(99) << "ms"
+		<< ", max " << getPercentile(100) << "ms";
+	return ss.str();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//Collects the time every frame of a benchmark or input replay took, and summarizes them so runs of different builds
+//can be compared. Percentiles show stutter that an average hides.
+class FrameTimeStats
+{
+public:
+	void add(float ms);
+	unsigned int getCount() const;
+
+	//percent between 0 and 100
+	float getPercentile(float percent) const;
+
+	//e.g. "1200 frames, mean 4.21ms, median 4.10ms, 90% 5.20ms, 99% 9.80ms, max 16.70ms"
+	std::string getSummary() const;
+
+private:
+	std::vector<float> mTimes;
+	mutable std::vector<float> mSorted; //only rebuilt when frames were added
+};
@@ -0,0 +1,217 @@
+#include "GLExtensions.h"
+#include "Log.h"
+#include <string>
+#include <sstream>
+#include <cstdlib>
+
+#ifdef USE_OPENGL_DESKTOP
+	#include "Renderer.h"
+#endif
+
+namespace GLExtensions
+{
+	bool etc1Supported = false;
+	bool npotMipmapsSupported = false;
+	bool framebuffersSupported = false;
+
+	bool hasExtension(const std::string& name)
+	{
+		const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+		if(extensions == NULL)
+			return false;
+
+		//match whole names only, some extensions are prefixes of others
+		std::istringstream stream(extensions);
+		std::string extension;
+		while(stream >> extension)
+		{
+			if(extension == name)
+				return true;
+		}
+
+		return false;
+	}
+
+	bool hasETC1()
+	{
+		return etc1Supported;
+	}
+
+	bool hasNPOTMipmaps()
+	{
+		return npotMipmapsSupported;
+	}
+
+	bool hasFramebuffers()
+	{
+		return framebuffersSupported;
+	}
+
+	void enableMipmapGeneration()
+	{
+#ifndef USE_OPENGL_ES2
+		glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+#endif
+	}
+
+	void updateMipmaps()
+	{
+#ifdef USE_OPENGL_ES2
+		glGenerateMipmap(GL_TEXTURE_2D);
+#endif
+	}
+
+#ifdef USE_OPENGL_DESKTOP
+	PFNGLGENBUFFERSPROC genBuffers = NULL;
+	PFNGLDELETEBUFFERSPROC deleteBuffers = NULL;
+	PFNGLBINDBUFFERPROC bindBuffer = NULL;
+	PFNGLBUFFERDATAPROC bufferData = NULL;
+	PFNGLBUFFERSUBDATAPROC bufferSubData = NULL;
+	PFNGLCOMPRESSEDTEXIMAGE2DPROC compressedTexImage2D = NULL;
+	PFNGLGENFRAMEBUFFERSPROC genFramebuffers = NULL;
+	PFNGLDELETEFRAMEBUFFERSPROC deleteFramebuffers = NULL;
+	PFNGLBINDFRAMEBUFFERPROC bindFramebuffer = NULL;
+	PFNGLFRAMEBUFFERTEXTURE2DPROC framebufferTexture2D = NULL;
+	PFNGLCHECKFRAMEBUFFERSTATUSPROC checkFramebufferStatus = NULL;
+#ifdef USE_SHADERS
+	PFNGLCREATESHADERPROC createShader = NULL;
+	PFNGLSHADERSOURCEPROC shaderSource = NULL;
+	PFNGLCOMPILESHADERPROC compileShader = NULL;
+	PFNGLGETSHADERIVPROC getShaderiv = NULL;
+	PFNGLGETSHADERINFOLOGPROC getShaderInfoLog = NULL;
+	PFNGLDELETESHADERPROC deleteShader = NULL;
+	PFNGLCREATEPROGRAMPROC createProgram = NULL;
+	PFNGLATTACHSHADERPROC attachShader = NULL;
+	PFNGLBINDATTRIBLOCATIONPROC bindAttribLocation = NULL;
+	PFNGLLINKPROGRAMPROC linkProgram = NULL;
+	PFNGLGETPROGRAMIVPROC getProgramiv = NULL;
+	PFNGLGETPROGRAMINFOLOGPROC getProgramInfoLog = NULL;
+	PFNGLDELETEPROGRAMPROC deleteProgram = NULL;
+	PFNGLUSEPROGRAMPROC useProgram = NULL;
+	PFNGLGETUNIFORMLOCATIONPROC getUniformLocation = NULL;
+	PFNGLUNIFORM1IPROC uniform1i = NULL;
+	PFNGLUNIFORM1FPROC uniform1f = NULL;
+	PFNGLUNIFORMMATRIX4FVPROC uniformMatrix4fv = NULL;
+	PFNGLVERTEXATTRIBPOINTERPROC vertexAttribPointer = NULL;
+	PFNGLENABLEVERTEXATTRIBARRAYPROC enableVertexAttribArray = NULL;
+	bool shadersSupported = false;
+#endif
+
+	//try the core name first, then the ARB and EXT extension names (same entry point on old drivers)
+	void* getProc(const std::string& name)
+	{
+		void* proc = Renderer::getProcAddress(name.c_str());
+		if(proc == NULL)
+			proc = Renderer::getProcAddress((name + "ARB").c_str());
+		if(proc == NULL)
+			proc = Renderer::getProcAddress((name + "EXT").c_str());
+
+		return proc;
+	}
+
+	void init()
+	{
+		genBuffers = (PFNGLGENBUFFERSPROC)getProc("glGenBuffers");
+		deleteBuffers = (PFNGLDELETEBUFFERSPROC)getProc("glDeleteBuffers");
+		bindBuffer = (PFNGLBINDBUFFERPROC)getProc("glBindBuffer");
+		bufferData = (PFNGLBUFFERDATAPROC)getProc("glBufferData");
+		bufferSubData = (PFNGLBUFFERSUBDATAPROC)getProc("glBufferSubData");
+		compressedTexImage2D = (PFNGLCOMPRESSEDTEXIMAGE2DPROC)getProc("glCompressedTexImage2D");
+		genFramebuffers = (PFNGLGENFRAMEBUFFERSPROC)getProc("glGenFramebuffers");
+		deleteFramebuffers = (PFNGLDELETEFRAMEBUFFERSPROC)getProc("glDeleteFramebuffers");
+		bindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC)getProc("glBindFramebuffer");
+		framebufferTexture2D = (PFNGLFRAMEBUFFERTEXTURE2DPROC)getProc("glFramebufferTexture2D");
+		checkFramebufferStatus = (PFNGLCHECKFRAMEBUFFERSTATUSPROC)getProc("glCheckFramebufferStatus");
+#ifdef USE_SHADERS
+		//the ARB_shader_objects names have different signatures, so only core GL 2.0 will do
+		createShader = (PFNGLCREATESHADERPROC)Renderer::getProcAddress("glCreateShader");
+		shaderSource = (PFNGLSHADERSOURCEPROC)Renderer::getProcAddress("glShaderSource");
+		compileShader = (PFNGLCOMPILESHADERPROC)Renderer::getProcAddress("glCompileShader");
+		getShaderiv = (PFNGLGETSHADERIVPROC)Renderer::getProcAddress("glGetShaderiv");
+		getShaderInfoLog = (PFNGLGETSHADERINFOLOGPROC)Renderer::getProcAddress("glGetShaderInfoLog");
+		deleteShader = (PFNGLDELETESHADERPROC)Renderer::getProcAddress("glDeleteShader");
+		createProgram = (PFNGLCREATEPROGRAMPROC)Renderer::getProcAddress("glCreateProgram");
+		attachShader = (PFNGLATTACHSHADERPROC)Renderer::getProcAddress("glAttachShader");
+		bindAttribLocation = (PFNGLBINDATTRIBLOCATIONPROC)Renderer::getProcAddress("glBindAttribLocation");
+		linkProgram = (PFNGLLINKPROGRAMPROC)Renderer::getProcAddress("glLinkProgram");
+		getProgramiv = (PFNGLGETPROGRAMIVPROC)Renderer::getProcAddress("glGetProgramiv");
+		getProgramInfoLog = (PFNGLGETPROGRAMINFOLOGPROC)Renderer::getProcAddress("glGetProgramInfoLog");
+		deleteProgram = (PFNGLDELETEPROGRAMPROC)Renderer::getProcAddress("glDeleteProgram");
+		useProgram = (PFNGLUSEPROGRAMPROC)Renderer::getProcAddress("glUseProgram");
+		getUniformLocation = (PFNGLGETUNIFORMLOCATIONPROC)Renderer::getProcAddress("glGetUniformLocation");
+		uniform1i = (PFNGLUNIFORM1IPROC)Renderer::getProcAddress("glUniform1i");
+		uniform1f = (PFNGLUNIFORM1FPROC)Renderer::getProcAddress("glUniform1f");
+		uniformMatrix4fv = (PFNGLUNIFORMMATRIX4FVPROC)Renderer::getProcAddress("glUniformMatrix4fv");
+		vertexAttribPointer = (PFNGLVERTEXATTRIBPOINTERPROC)Renderer::getProcAddress("glVertexAttribPointer");
+		enableVertexAttribArray = (PFNGLENABLEVERTEXATTRIBARRAYPROC)Renderer::getProcAddress("glEnableVertexAttribArray");
+
+		shadersSupported = createShader != NULL && shaderSource != NULL && compileShader != NULL && getShaderiv != NULL
+			&& getShaderInfoLog != NULL && deleteShader != NULL && createProgram != NULL && attachShader != NULL && bindAttribLocation != NULL
+			&& linkProgram != NULL && getProgramiv != NULL && getProgramInfoLog != NULL && deleteProgram != NULL && useProgram != NULL
+			&& getUniformLocation != NULL && uniform1i != NULL && uniform1f != NULL && uniformMatrix4fv != NULL
+			&& vertexAttribPointer != NULL && enableVertexAttribArray != NULL;
+#endif
+
+		if(!hasVertexBuffers())
+			LOG(LogWarning) << "No vertex buffer object support, drawing from client memory.";
+
+		etc1Supported = compressedTexImage2D != NULL && hasExtension("GL_ARB_ES3_compatibility");
+
+		//GL 2.0 lifted the power of two restriction
+		const char* version = (const char*)glGetString(GL_VERSION);
+		npotMipmapsSupported = (version != NULL && atoi(version) >= 2) || hasExtension("GL_ARB_texture_non_power_of_two");
+
+		framebuffersSupported = genFramebuffers != NULL && deleteFramebuffers != NULL && bindFramebuffer != NULL
+			&& framebufferTexture2D != NULL && checkFramebufferStatus != NULL;
+	}
+
+	bool hasVertexBuffers()
+	{
+		return genBuffers != NULL && deleteBuffers != NULL && bindBuffer != NULL && bufferData != NULL && bufferSubData != NULL;
+	}
+
+	bool hasShaders()
+	{
+#ifdef USE_SHADERS
+		return shadersSupported;
+#else
+		return false; //not loaded, the fixed-function backend doesn't need them
+#endif
+	}
+
+	GLenum getETC1Format()
+	{
+		return GL_COMPRESSED_RGB8_ETC2;
+	}
+#else
+	void init()
+	{
+		etc1Supported = hasExtension("GL_OES_compressed_ETC1_RGB8_texture");
+		npotMipmapsSupported = hasExtension("GL_OES_texture_npot") || hasExtension("GL_ARB_texture_non_power_of_two");
+#ifdef USE_OPENGL_ES2
+		framebuffersSupported = true;
+#else
+		framebuffersSupported = hasExtension("GL_OES_framebuffer_object");
+#endif
+	}
+
+	bool hasVertexBuffers()
+	{
+		return true;
+	}
+
+	bool hasShaders()
+	{
+#ifdef USE_OPENGL_ES2
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	GLenum getETC1Format()
+	{
+		return GL_ETC1_RGB8_OES;
+	}
+#endif
+}
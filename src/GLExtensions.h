@@ -0,0 +1,139 @@
+#pragma once
+
+#include "platform.h"
+#include GLHEADER
+#include <string>
+
+//Access to OpenGL functions beyond what the platform headers/libraries give us directly.
+//SDL 1.2's SDL_opengl.h doesn't declare anything newer than GL 1.1/1.3 and Windows only exports 1.1, so on desktop
+//GL these are loaded at runtime and the usual gl* names are mapped onto the loaded pointers.
+//OpenGL ES 1.1 has most of what we use in its core. Its extensions are used through the OES names the GLES libraries export.
+//OpenGL ES 2 has everything in its core.
+namespace GLExtensions
+{
+	//Loads the function pointers. Needs a current GL context, call again after the context was recreated.
+	void init();
+
+	//Vertex buffer objects (GL 1.5 or ARB_vertex_buffer_object, always present in GLES 1.1).
+	bool hasVertexBuffers();
+
+	//True if the GL_EXTENSIONS string lists name.
+	bool hasExtension(const std::string& name);
+
+	//ETC1 compressed textures (OES_compressed_ETC1_RGB8_texture on GLES, or ETC2 from ARB_ES3_compatibility on desktop GL, which decodes ETC1 too).
+	bool hasETC1();
+	GLenum getETC1Format(); //internal format to pass to glCompressedTexImage2D
+
+	//Mipmaps for textures whose sizes aren't powers of two (GL 2.0, ARB_texture_non_power_of_two or OES_texture_npot).
+	bool hasNPOTMipmaps();
+
+	//Framebuffer objects (GL 3.0, ARB/EXT_framebuffer_object or OES_framebuffer_object, always present in GLES 2).
+	bool hasFramebuffers();
+
+	//GLSL shaders (GL 2.0, always present in GLES 2). Needed by builds with USE_SHADERS.
+	bool hasShaders();
+
+	//Mipmaps for the bound texture. Call enableMipmapGeneration() before the first upload and updateMipmaps() after every upload.
+	//GL 1.4+ and GLES 1.1 regenerate them by themselves whenever level 0 changes (GL_GENERATE_MIPMAP), GLES 2 has to be told.
+	void enableMipmapGeneration();
+	void updateMipmaps();
+}
+
+#ifndef GL_ETC1_RGB8_OES
+	#define GL_ETC1_RGB8_OES 0x8D64
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+	#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+
+#ifdef USE_OPENGL_DESKTOP
+namespace GLExtensions
+{
+	extern PFNGLGENBUFFERSPROC genBuffers;
+	extern PFNGLDELETEBUFFERSPROC deleteBuffers;
+	extern PFNGLBINDBUFFERPROC bindBuffer;
+	extern PFNGLBUFFERDATAPROC bufferData;
+	extern PFNGLBUFFERSUBDATAPROC bufferSubData;
+	extern PFNGLCOMPRESSEDTEXIMAGE2DPROC compressedTexImage2D;
+	extern PFNGLGENFRAMEBUFFERSPROC genFramebuffers;
+	extern PFNGLDELETEFRAMEBUFFERSPROC deleteFramebuffers;
+	extern PFNGLBINDFRAMEBUFFERPROC bindFramebuffer;
+	extern PFNGLFRAMEBUFFERTEXTURE2DPROC framebufferTexture2D;
+	extern PFNGLCHECKFRAMEBUFFERSTATUSPROC checkFramebufferStatus;
+#ifdef USE_SHADERS
+	extern PFNGLCREATESHADERPROC createShader;
+	extern PFNGLSHADERSOURCEPROC shaderSource;
+	extern PFNGLCOMPILESHADERPROC compileShader;
+	extern PFNGLGETSHADERIVPROC getShaderiv;
+	extern PFNGLGETSHADERINFOLOGPROC getShaderInfoLog;
+	extern PFNGLDELETESHADERPROC deleteShader;
+	extern PFNGLCREATEPROGRAMPROC createProgram;
+	extern PFNGLATTACHSHADERPROC attachShader;
+	extern PFNGLBINDATTRIBLOCATIONPROC bindAttribLocation;
+	extern PFNGLLINKPROGRAMPROC linkProgram;
+	extern PFNGLGETPROGRAMIVPROC getProgramiv;
+	extern PFNGLGETPROGRAMINFOLOGPROC getProgramInfoLog;
+	extern PFNGLDELETEPROGRAMPROC deleteProgram;
+	extern PFNGLUSEPROGRAMPROC useProgram;
+	extern PFNGLGETUNIFORMLOCATIONPROC getUniformLocation;
+	extern PFNGLUNIFORM1IPROC uniform1i;
+	extern PFNGLUNIFORM1FPROC uniform1f;
+	extern PFNGLUNIFORMMATRIX4FVPROC uniformMatrix4fv;
+	extern PFNGLVERTEXATTRIBPOINTERPROC vertexAttribPointer;
+	extern PFNGLENABLEVERTEXATTRIBARRAYPROC enableVertexAttribArray;
+#endif
+}
+
+#define glGenBuffers GLExtensions::genBuffers
+#define glDeleteBuffers GLExtensions::deleteBuffers
+#define glBindBuffer GLExtensions::bindBuffer
+#define glBufferData GLExtensions::bufferData
+#define glBufferSubData GLExtensions::bufferSubData
+#define glCompressedTexImage2D GLExtensions::compressedTexImage2D
+#define glGenFramebuffers GLExtensions::genFramebuffers
+#define glDeleteFramebuffers GLExtensions::deleteFramebuffers
+#define glBindFramebuffer GLExtensions::bindFramebuffer
+#define glFramebufferTexture2D GLExtensions::framebufferTexture2D
+#define glCheckFramebufferStatus GLExtensions::checkFramebufferStatus
+#ifdef USE_SHADERS
+	#define glCreateShader GLExtensions::createShader
+	#define glShaderSource GLExtensions::shaderSource
+	#define glCompileShader GLExtensions::compileShader
+	#define glGetShaderiv GLExtensions::getShaderiv
+	#define glGetShaderInfoLog GLExtensions::getShaderInfoLog
+	#define glDeleteShader GLExtensions::deleteShader
+	#define glCreateProgram GLExtensions::createProgram
+	#define glAttachShader GLExtensions::attachShader
+	#define glBindAttribLocation GLExtensions::bindAttribLocation
+	#define glLinkProgram GLExtensions::linkProgram
+	#define glGetProgramiv GLExtensions::getProgramiv
+	#define glGetProgramInfoLog GLExtensions::getProgramInfoLog
+	#define glDeleteProgram GLExtensions::deleteProgram
+	#define glUseProgram GLExtensions::useProgram
+	#define glGetUniformLocation GLExtensions::getUniformLocation
+	#define glUniform1i GLExtensions::uniform1i
+	#define glUniform1f GLExtensions::uniform1f
+	#define glUniformMatrix4fv GLExtensions::uniformMatrix4fv
+	#define glVertexAttribPointer GLExtensions::vertexAttribPointer
+	#define glEnableVertexAttribArray GLExtensions::enableVertexAttribArray
+#endif
+#endif
+
+#if defined(USE_OPENGL_ES) && !defined(USE_OPENGL_ES2)
+	#ifndef GL_GLEXT_PROTOTYPES
+		#define GL_GLEXT_PROTOTYPES
+	#endif
+	#include <GLES/glext.h>
+
+	#define glGenFramebuffers glGenFramebuffersOES
+	#define glDeleteFramebuffers glDeleteFramebuffersOES
+	#define glBindFramebuffer glBindFramebufferOES
+	#define glFramebufferTexture2D glFramebufferTexture2DOES
+	#define glCheckFramebufferStatus glCheckFramebufferStatusOES
+
+	#ifndef GL_FRAMEBUFFER
+		#define GL_FRAMEBUFFER GL_FRAMEBUFFER_OES
+		#define GL_COLOR_ATTACHMENT0 GL_COLOR_ATTACHMENT0_OES
+		#define GL_FRAMEBUFFER_COMPLETE GL_FRAMEBUFFER_COMPLETE_OES
+	#endif
+#endif
@@ -1,6 +1,7 @@
 #include "GameData.h"
 #include <boost/filesystem.hpp>
 #include <iostream>
+#include "MemoryStats.h"
 
 
 const std::string GameData::xmlTagGameList = "gameList";
@@ -16,9 +17,31 @@ const std::string GameData::xmlTagLastPlayed = "lastplayed";
 const std::string GameData::xmlTagHidden = "hidden";
 
 
+//what a string allocated outside of itself. short strings are stored in the string object (and counted with sizeof(GameData))
+static size_t getHeapBytes(const std::string & str)
+{
+	const char * object = (const char *)&str;
+	if (str.data() >= object && str.data() < object + sizeof(std::string))
+		return 0;
+	return str.capacity() + 1;
+}
+
 GameData::GameData(SystemData* system, std::string path, std::string name)
 	: mSystem(system), mPath(path), mName(name), mRating(0.0f), mUserRating(0.0f), mTimesPlayed(0), mLastPlayed(0), mHidden(false)
 {
+	MemoryStats::add(MemoryStats::CATEGORY_GAME_DATA, sizeof(GameData) + getHeapBytes(mPath) + getHeapBytes(mName) + getHeapBytes(mDescription) + getHeapBytes(mImagePath));
+}
+
+GameData::~GameData()
+{
+	MemoryStats::remove(MemoryStats::CATEGORY_GAME_DATA, sizeof(GameData) + getHeapBytes(mPath) + getHeapBytes(mName) + getHeapBytes(mDescription) + getHeapBytes(mImagePath));
+}
+
+void GameData::setString(std::string & member, const std::string & value)
+{
+	MemoryStats::remove(MemoryStats::CATEGORY_GAME_DATA, getHeapBytes(member));
+	member = value;
+	MemoryStats::add(MemoryStats::CATEGORY_GAME_DATA, getHeapBytes(member));
 }
 
 bool GameData::isFolder() const
@@ -33,7 +56,7 @@ const std::string & GameData::getName() const
 
 void GameData::setName(const std::string & name)
 {
-	mName = name;
+	setString(mName, name);
 }
 
 const std::string & GameData::getPath() const
@@ -43,7 +66,7 @@ const std::string & GameData::getPath() const
 
 void GameData::setPath(const std::string & path)
 {
-	mPath = path;
+	setString(mPath, path);
 }
 
 const std::string & GameData::getDescription() const
@@ -53,7 +76,7 @@ const std::string & GameData::getDescription() const
 
 void GameData::setDescription(const std::string & description)
 {
-	mDescription = description;
+	setString(mDescription, description);
 }
 
 const std::string & GameData::getImagePath() const
@@ -63,7 +86,7 @@ const std::string & GameData::getImagePath() const
 
 void GameData::setImagePath(const std::string & imagePath)
 {
-	mImagePath = imagePath;
+	setString(mImagePath, imagePath);
 }
 
 float GameData::getRating() const
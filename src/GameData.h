@@ -26,6 +26,7 @@ public:
 	static const std::string xmlTagHidden;
 
 	GameData(SystemData* system, std::string path, std::string name);
+	~GameData();
 
 	const std::string & getName() const;
 	void setName(const std::string & name);
@@ -59,6 +60,9 @@ public:
 
 	bool isFolder() const;
 private:
+	//keeps the MemoryStats of the strings up to date (counting their capacity, roughly what they take up)
+	void setString(std::string & member, const std::string & value);
+
 	SystemData* mSystem;
 	std::string mPath;
 	std::string mName;
@@ -2,6 +2,7 @@
 #include "Window.h"
 #include "Log.h"
 #include "Renderer.h"
+#include "Profiler.h"
 
 GuiComponent::GuiComponent(Window* window) : mWindow(window), mParent(NULL), mOpacity(255), 
 	mPosition(Eigen::Vector3f::Zero()), mSize(Eigen::Vector2f::Zero()), mTransform(Eigen::Affine3f::Identity())
@@ -34,6 +35,7 @@ void GuiComponent::update(int deltaTime)
 {
 	for(unsigned int i = 0; i < getChildCount(); i++)
 	{
+		ProfileScope scope(getChild(i), Profiler::PHASE_UPDATE);
 		getChild(i)->update(deltaTime);
 	}
 }
@@ -48,6 +50,7 @@ void GuiComponent::renderChildren(const Eigen::Affine3f& transform) const
 {
 	for(unsigned int i = 0; i < getChildCount(); i++)
 	{
+		ProfileScope scope(getChild(i), Profiler::PHASE_RENDER);
 		getChild(i)->render(transform);
 	}
 }
@@ -60,12 +63,14 @@ Eigen::Vector3f GuiComponent::getPosition() const
 void GuiComponent::setPosition(const Eigen::Vector3f& offset)
 {
 	mPosition = offset;
+	markDirty();
 	onPositionChanged();
 }
 
 void GuiComponent::setPosition(float x, float y, float z)
 {
 	mPosition << x, y, z;
+	markDirty();
 	onPositionChanged();
 }
 
@@ -77,12 +82,14 @@ Eigen::Vector2f GuiComponent::getSize() const
 void GuiComponent::setSize(const Eigen::Vector2f& size)
 {
     mSize = size;
+    markDirty();
     onSizeChanged();
 }
 
 void GuiComponent::setSize(float w, float h)
 {
 	mSize << w, h;
+	markDirty();
     onSizeChanged();
 }
 
@@ -90,6 +97,7 @@ void GuiComponent::setSize(float w, float h)
 void GuiComponent::addChild(GuiComponent* cmp)
 {
 	mChildren.push_back(cmp);
+	markDirty();
 
 	if(cmp->getParent())
 		cmp->getParent()->removeChild(cmp);
@@ -111,6 +119,7 @@ void GuiComponent::removeChild(GuiComponent* cmp)
 		if(*i == cmp)
 		{
 			mChildren.erase(i);
+			markDirty();
 			return;
 		}
 	}
@@ -119,6 +128,7 @@ void GuiComponent::removeChild(GuiComponent* cmp)
 void GuiComponent::clearChildren()
 {
 	mChildren.clear();
+	markDirty();
 }
 
 unsigned int GuiComponent::getChildCount() const
@@ -148,6 +158,9 @@ unsigned char GuiComponent::getOpacity() const
 
 void GuiComponent::setOpacity(unsigned char opacity)
 {
+	if(mOpacity != opacity)
+		markDirty();
+
 	mOpacity = opacity;
 }
 
@@ -157,3 +170,8 @@ const Eigen::Affine3f GuiComponent::getTransform()
 	mTransform.translate(mPosition);
 	return mTransform;
 }
+
+void GuiComponent::markDirty()
+{
+	mWindow->invalidate();
+}
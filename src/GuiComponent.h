@@ -51,6 +51,10 @@ public:
 
 	const Eigen::Affine3f getTransform();
 
+	//Tells the window that this component looks different now and the next frame has to be drawn.
+	//Call this whenever something changes that render() would draw differently - the window skips frames otherwise.
+	void markDirty();
+
 protected:
 	void renderChildren(const Eigen::Affine3f& transform) const;
 
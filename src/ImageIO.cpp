@@ -1,13 +1,42 @@
 #include "ImageIO.h"
 
 #include <memory.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define IMAGEIO_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+	#include <arm_neon.h>
+	#define IMAGEIO_NEON
+#endif
 
 #include "Log.h"
 
 
-std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height)
+//how much an image has to be scaled so every nonzero bound is still covered, e.g. a bounding width and height with another
+//aspect ratio than the image leave one side bigger than its bound. the final size is set when the image is drawn.
+static float getCoverScale(const size_t srcWidth, const size_t srcHeight, const size_t maxWidth, const size_t maxHeight)
+{
+	float scale = 0.0f;
+	if (maxWidth != 0 && srcWidth != 0)
+		scale = (float)maxWidth / srcWidth;
+	if (maxHeight != 0 && srcHeight != 0)
+		scale = std::max(scale, (float)maxHeight / srcHeight);
+	return (scale > 0.0f && scale < 1.0f) ? scale : 1.0f;
+}
+
+std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height, const size_t maxWidth, const size_t maxHeight)
 {
 	std::vector<unsigned char> rawData;
+	loadFromMemoryRGBA32(data, size, rawData, width, height, maxWidth, maxHeight);
+	return rawData;
+}
+
+bool ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const size_t size, std::vector<unsigned char> & rawData, size_t & width, size_t & height, const size_t maxWidth, const size_t maxHeight)
+{
+	rawData.clear();
 	width = 0;
 	height = 0;
 	FIMEMORY * fiMemory = FreeImage_OpenMemory((BYTE *)data, size);
@@ -17,7 +46,26 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
 		if (format != FIF_UNKNOWN && FreeImage_FIFSupportsReading(format))
 		{
 			//file type is supported. load image
-			FIBITMAP * fiBitmap = FreeImage_LoadFromMemory(format, fiMemory);
+			//the JPEG loader can decode at 1/2, 1/4 or 1/8 size right away if we tell it the size we want in the upper 16 bits.
+			//it applies that size to the longer side, so read the header first to work out how long that side has to stay
+			int flags = 0;
+#ifdef FIF_LOAD_NOPIXELS
+			if (format == FIF_JPEG && (maxWidth != 0 || maxHeight != 0))
+			{
+				FIBITMAP * fiHeader = FreeImage_LoadFromMemory(format, fiMemory, FIF_LOAD_NOPIXELS);
+				FreeImage_SeekMemory(fiMemory, 0, SEEK_SET);
+				if (fiHeader != nullptr)
+				{
+					const size_t srcWidth = FreeImage_GetWidth(fiHeader);
+					const size_t srcHeight = FreeImage_GetHeight(fiHeader);
+					FreeImage_Unload(fiHeader);
+					const float scale = getCoverScale(srcWidth, srcHeight, maxWidth, maxHeight);
+					if (scale < 1.0f)
+						flags = (int)ceil(std::max(srcWidth, srcHeight) * scale) << 16;
+				}
+			}
+#endif
+			FIBITMAP * fiBitmap = FreeImage_LoadFromMemory(format, fiMemory, flags);
 			if (fiBitmap != nullptr)
 			{
 				//loaded. convert to 32bit if necessary
@@ -34,32 +82,36 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
 				}
 				if (fiBitmap != nullptr)
 				{
+					//scale down towards the requested size, so we don't waste memory on pixels that are never shown.
+					//done after the conversion, so palette images keep their transparency
+					if (maxWidth != 0 || maxHeight != 0)
+					{
+						const size_t srcWidth = FreeImage_GetWidth(fiBitmap);
+						const size_t srcHeight = FreeImage_GetHeight(fiBitmap);
+						const float scale = getCoverScale(srcWidth, srcHeight, maxWidth, maxHeight);
+						if (scale < 1.0f)
+						{
+							const int dstWidth = std::max(1, (int)(srcWidth * scale + 0.5f));
+							const int dstHeight = std::max(1, (int)(srcHeight * scale + 0.5f));
+							FIBITMAP * fiScaled = FreeImage_Rescale(fiBitmap, dstWidth, dstHeight, FILTER_BILINEAR);
+							if (fiScaled != nullptr)
+							{
+								FreeImage_Unload(fiBitmap);
+								fiBitmap = fiScaled;
+							}
+						}
+					}
+
 					width = FreeImage_GetWidth(fiBitmap);
 					height = FreeImage_GetHeight(fiBitmap);
-					unsigned int pitch = FreeImage_GetPitch(fiBitmap);
-					//loop through scanlines and add all pixel data to the return vector
-					//this is necessary, because width*height*bpp might not be == pitch
-					unsigned char * tempData = new unsigned char[width * height * 4];
+					//convert every scanline straight into the result, pitch might not be == width*4
+					rawData.resize(width * height * 4);
 					for (size_t i = 0; i < height; i++)
 					{
-						const BYTE * scanLine = FreeImage_GetScanLine(fiBitmap, i);
-						memcpy(tempData + (i * width * 4), scanLine, width * 4);
-					}
-					//convert from BGRA to RGBA
-					for(size_t i = 0; i < width*height; i++)
-					{
-						RGBQUAD bgra = ((RGBQUAD *)tempData)[i];
-						RGBQUAD rgba;
-						rgba.rgbBlue = bgra.rgbRed;
-						rgba.rgbGreen = bgra.rgbGreen;
-						rgba.rgbRed = bgra.rgbBlue;
-						rgba.rgbReserved = bgra.rgbReserved;
-						((RGBQUAD *)tempData)[i] = rgba;
+						convertBGRAToRGBA(FreeImage_GetScanLine(fiBitmap, i), rawData.data() + (i * width * 4), width);
 					}
-					rawData = std::vector<unsigned char>(tempData, tempData + width * height * 4);
 					//free bitmap data
 					FreeImage_Unload(fiBitmap);
-					delete[] tempData;
 				}
 			}
 			else
@@ -74,5 +126,44 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
 		//free FIMEMORY again
 		FreeImage_CloseMemory(fiMemory);
 	}
-	return rawData;
+	return !rawData.empty();
+}
+
+void ImageIO::convertBGRAToRGBA(const unsigned char * src, unsigned char * dst, const size_t pixelCount)
+{
+	size_t i = 0;
+
+#if defined(IMAGEIO_SSE2)
+	//4 pixels at a time: keep green and alpha, move blue up and red down by 16 bits
+	const __m128i maskGA = _mm_set1_epi32(0xFF00FF00);
+	const __m128i maskLow = _mm_set1_epi32(0x000000FF);
+	for (; i + 4 <= pixelCount; i += 4)
+	{
+		const __m128i bgra = _mm_loadu_si128((const __m128i *)(src + i * 4));
+		const __m128i ga = _mm_and_si128(bgra, maskGA);
+		const __m128i r = _mm_and_si128(_mm_srli_epi32(bgra, 16), maskLow);
+		const __m128i b = _mm_slli_epi32(_mm_and_si128(bgra, maskLow), 16);
+		_mm_storeu_si128((__m128i *)(dst + i * 4), _mm_or_si128(ga, _mm_or_si128(r, b)));
+	}
+#elif defined(IMAGEIO_NEON)
+	//16 pixels at a time, the interleaved load splits the channels for us
+	for (; i + 16 <= pixelCount; i += 16)
+	{
+		uint8x16x4_t pixels = vld4q_u8(src + i * 4);
+		const uint8x16_t blue = pixels.val[0];
+		pixels.val[0] = pixels.val[2];
+		pixels.val[2] = blue;
+		vst4q_u8(dst + i * 4, pixels);
+	}
+#endif
+
+	//the rest (or everything, without SIMD)
+	for (; i < pixelCount; i++)
+	{
+		const unsigned char blue = src[i * 4];
+		dst[i * 4] = src[i * 4 + 2];
+		dst[i * 4 + 1] = src[i * 4 + 1];
+		dst[i * 4 + 2] = blue;
+		dst[i * 4 + 3] = src[i * 4 + 3];
+	}
 }
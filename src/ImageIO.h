@@ -7,5 +7,15 @@
 class ImageIO
 {
 public:
-	static std::vector<unsigned char> loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height);
+	//Decodes an image to RGBA pixels. If maxWidth and/or maxHeight are nonzero, larger images are scaled down (keeping their aspect ratio)
+	//while decoding, but never below a nonzero bound, so they can still be drawn at exactly that size - width and height return the scaled size.
+	static std::vector<unsigned char> loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height, const size_t maxWidth = 0, const size_t maxHeight = 0);
+
+	//Same as above, but decodes into rawData, so a buffer that's already big enough can be reused instead of allocating a new one.
+	//Returns false (and leaves rawData empty) if the image could not be decoded.
+	static bool loadFromMemoryRGBA32(const unsigned char * data, const size_t size, std::vector<unsigned char> & rawData, size_t & width, size_t & height, const size_t maxWidth = 0, const size_t maxHeight = 0);
+
+	//Swaps the red and blue channels of pixelCount 32-bit pixels while copying them from src to dst (may be the same buffer).
+	//Uses SSE2 or NEON when the compiler targets them.
+	static void convertBGRAToRGBA(const unsigned char * src, unsigned char * dst, const size_t pixelCount);
 };
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "InputRecording.h"
+#include "Log.h"
+#include <sstream>
+#include <cstring>
+
+std::ofstream InputRecording::sRecordFile;
+unsigned int InputRecording::sRecordedCount = 0;
+
+bool InputRecording::sReplaying = false;
+std::vector<InputRecording::RecordedEvent> InputRecording::sReplayEvents;
+unsigned int InputRecording::sNextReplayEvent = 0;
+
+bool InputRecording::startRecording(const std::string& path)
+{
+	sRecordFile.open(path.c_str());
+	if(!sRecordFile.is_open())
+	{
+		LOG(LogError) << "Could not open \"" << path << "\" to record input to!";
+		return false;
+	}
+
+	sRecordedCount = 0;
+	sRecordFile << "#EmulationStation input recording\n";
+	LOG(LogInfo) << "Recording input to \"" << path << "\".";
+	return true;
+}
+
+void InputRecording::record(const SDL_Event& event, int time)
+{
+	if(!sRecordFile.is_open())
+		return;
+
+	switch(event.type)
+	{
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+		sRecordFile << time << (event.type == SDL_KEYDOWN ? " keydown " : " keyup ") << event.key.keysym.sym << "\n";
+		break;
+	case SDL_JOYBUTTONDOWN:
+	case SDL_JOYBUTTONUP:
+		sRecordFile << time << (event.type == SDL_JOYBUTTONDOWN ? " buttondown " : " buttonup ") << (int)event.jbutton.which << " " << (int)event.jbutton.button << "\n";
+		break;
+	case SDL_JOYHATMOTION:
+		sRecordFile << time << " hat " << (int)event.jhat.which << " " << (int)event.jhat.hat << " " << (int)event.jhat.value << "\n";
+		break;
+	case SDL_JOYAXISMOTION:
+		sRecordFile << time << " axis " << (int)event.jaxis.which << " " << (int)event.jaxis.axis << " " << event.jaxis.value << "\n";
+		break;
+	default:
+		return;
+	}
+
+	sRecordedCount++;
+}
+
+void InputRecording::stopRecording()
+{
+	if(!sRecordFile.is_open())
+		return;
+
+	sRecordFile.close();
+	LOG(LogInfo) << "Recorded " << sRecordedCount << " input events.";
+}
+
+bool InputRecording::loadReplay(const std::string& path, int joystickCount)
+{
+	std::ifstream file(path.c_str());
+	if(!file.is_open())
+	{
+		LOG(LogError) << "Could not open input recording \"" << path << "\"!";
+		return false;
+	}
+
+	sReplayEvents.clear();
+	sNextReplayEvent = 0;
+	unsigned int dropped = 0;
+
+	std::string line;
+	for(int lineNumber = 1; std::getline(file, line); lineNumber++)
+	{
+		if(line.empty() || line[0] == '#')
+			continue;
+
+		std::stringstream ss(line);
+		RecordedEvent recorded;
+		std::string type;
+		ss >> recorded.time >> type;
+
+		SDL_Event& event = recorded.event;
+		memset(&event, 0, sizeof(event));
+
+		int joystick = -1;
+		int a = 0, b = 0;
+		if(type == "keydown" || type == "keyup")
+		{
+			ss >> a;
+			event.type = (type == "keydown") ? SDL_KEYDOWN : SDL_KEYUP;
+			event.key.type = event.type;
+			event.key.state = (type == "keydown") ? SDL_PRESSED : SDL_RELEASED;
+			event.key.keysym.sym = (SDLKey)a;
+		}else if(type == "buttondown" || type == "buttonup")
+		{
+			ss >> joystick >> a;
+			event.type = (type == "buttondown") ? SDL_JOYBUTTONDOWN : SDL_JOYBUTTONUP;
+			event.jbutton.type = event.type;
+			event.jbutton.which = joystick;
+			event.jbutton.button = a;
+			event.jbutton.state = (type == "buttondown") ? SDL_PRESSED : SDL_RELEASED;
+		}else if(type == "hat")
+		{
+			ss >> joystick >> a >> b;
+			event.type = SDL_JOYHATMOTION;
+			event.jhat.type = event.type;
+			event.jhat.which = joystick;
+			event.jhat.hat = a;
+			event.jhat.value = b;
+		}else if(type == "axis")
+		{
+			ss >> joystick >> a >> b;
+			event.type = SDL_JOYAXISMOTION;
+			event.jaxis.type = event.type;
+			event.jaxis.which = joystick;
+			event.jaxis.axis = a;
+			event.jaxis.value = b;
+		}else{
+			ss.setstate(std::ios::failbit);
+		}
+
+		if(ss.fail())
+		{
+			LOG(LogError) << "Input recording \"" << path << "\", line " << lineNumber << ": can't read \"" << line << "\"!";
+			return false;
+		}
+
+		if(joystick >= joystickCount)
+		{
+			dropped++;
+			continue;
+		}
+
+		sReplayEvents.push_back(recorded);
+	}
+
+	if(dropped > 0)
+		LOG(LogWarning) << "Dropped " << dropped << " events of joysticks that aren't connected from the input recording.";
+
+	sReplaying = true;
+	LOG(LogInfo) << "Replaying " << sReplayEvents.size() << " input events from \"" << path << "\".";
+	return true;
+}
+
+bool InputRecording::getNextEvent(int time, SDL_Event* event)
+{
+	if(sNextReplayEvent >= sReplayEvents.size() || sReplayEvents.at(sNextReplayEvent).time > time)
+		return false;
+
+	*event = sReplayEvents.at(sNextReplayEvent).event;
+	sNextReplayEvent++;
+	return true;
+}
+
+bool InputRecording::isReplayFinished()
+{
+	return sNextReplayEvent >= sReplayEvents.size();
+}
+
+int InputRecording::getReplayEndTime()
+{
+	return sReplayEvents.empty() ? 0 : sReplayEvents.back().time;
+}
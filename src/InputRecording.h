@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+//Records the input events the main loop hands to the InputManager, with the time they happened at, and plays them back.
+//Times are milliseconds since the main loop started. Record in real time, then replay with --fixed-step: the main loop's clock
+//is simulated then, so every replay delivers each event on the same frame and drives the UI through the same states, which
+//makes the frame times of different builds comparable.
+//The file is plain text, one event per line: "<time> keydown|keyup <sym>", "<time> buttondown|buttonup <joystick> <button>",
+//"<time> hat <joystick> <hat> <value>" or "<time> axis <joystick> <axis> <value>". Lines starting with # are comments.
+class InputRecording
+{
+public:
+	static bool startRecording(const std::string& path);
+	static inline bool isRecording() { return sRecordFile.is_open(); }
+	static void record(const SDL_Event& event, int time);
+	static void stopRecording();
+
+	//Events for joysticks the recording machine had but this one doesn't (numbers >= joystickCount) are dropped.
+	static bool loadReplay(const std::string& path, int joystickCount);
+	static inline bool isReplaying() { return sReplaying; }
+
+	//Gets the next event that happened at or before time. Returns false if there is none (yet).
+	static bool getNextEvent(int time, SDL_Event* event);
+	static bool isReplayFinished();
+	static int getReplayEndTime(); //time of the last event
+
+private:
+	struct RecordedEvent
+	{
+		int time;
+		SDL_Event event;
+	};
+
+	static std::ofstream sRecordFile;
+	static unsigned int sRecordedCount;
+
+	static bool sReplaying;
+	static std::vector<RecordedEvent> sReplayEvents;
+	static unsigned int sNextReplayEvent;
+};
@@ -0,0 +1,48 @@
+#include "MemoryStats.h"
+#include "Log.h"
+#include <sstream>
+#include <iomanip>
+
+size_t MemoryStats::sBytes[CATEGORY_COUNT] = { 0 };
+size_t MemoryStats::sPeakBytes[CATEGORY_COUNT] = { 0 };
+
+static const char* categoryNames[MemoryStats::CATEGORY_COUNT] = { "textures", "fonts", "sounds", "game data" };
+
+size_t MemoryStats::getBytes(Category category)
+{
+	return sBytes[category];
+}
+
+size_t MemoryStats::getPeakBytes(Category category)
+{
+	return sPeakBytes[category];
+}
+
+const char* MemoryStats::getName(Category category)
+{
+	return categoryNames[category];
+}
+
+std::string MemoryStats::getSummary()
+{
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(1);
+	for(int i = 0; i < CATEGORY_COUNT; i++)
+	{
+		if(i != 0)
+			ss << ", ";
+		ss << categoryNames[i] << " " << sBytes[i] / (1024.0f * 1024.0f) << "MB";
+	}
+	return ss.str();
+}
+
+void MemoryStats::logStats()
+{
+	size_t total = 0;
+	for(int i = 0; i < CATEGORY_COUNT; i++)
+	{
+		LOG(LogInfo) << "Memory: " << categoryNames[i] << " " << (sBytes[i] / 1024) << "kB (peak " << (sPeakBytes[i] / 1024) << "kB)";
+		total += sBytes[i];
+	}
+	LOG(LogInfo) << "Memory: " << (total / 1024) << "kB counted in total.";
+}
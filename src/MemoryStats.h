@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+//Bytes held by the big consumers of memory, counted by the code that allocates and frees them. Everything here is only used
+//from the main thread. Texture and font sizes are what the GL needs to store them, not what the driver really allocates.
+//Shown with --draw-memory, and logged after startup and on exit.
+class MemoryStats
+{
+public:
+	enum Category
+	{
+		CATEGORY_TEXTURES, //TextureResources, atlas pages and free pooled textures (GPU)
+		CATEGORY_FONTS, //glyph atlases (GPU)
+		CATEGORY_SOUNDS, //converted sample buffers
+		CATEGORY_GAME_DATA, //GameData objects and their strings, an estimate
+		CATEGORY_COUNT
+	};
+
+	static inline void add(Category category, size_t bytes)
+	{
+		sBytes[category] += bytes;
+		if(sBytes[category] > sPeakBytes[category])
+			sPeakBytes[category] = sBytes[category];
+	}
+
+	static inline void remove(Category category, size_t bytes)
+	{
+		sBytes[category] = (bytes > sBytes[category]) ? 0 : sBytes[category] - bytes;
+	}
+
+	static size_t getBytes(Category category);
+	static size_t getPeakBytes(Category category);
+	static const char* getName(Category category);
+
+	//One line with the current size of every category, e.g. for drawing it on screen.
+	static std::string getSummary();
+	static void logStats();
+
+private:
+	static size_t sBytes[CATEGORY_COUNT];
+	static size_t sPeakBytes[CATEGORY_COUNT];
+};
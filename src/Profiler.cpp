@@ -0,0 +1,324 @@
+#include "Profiler.h"
+#include "GuiComponent.h"
+#include "Renderer.h"
+#include "Font.h"
+#include "Log.h"
+#include <chrono>
+#include <typeinfo>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#ifdef __GNUC__
+	#include <cxxabi.h>
+#endif
+
+#define PROFILER_OVERLAY_COMPONENTS 8 //slowest component classes listed in the overlay
+#define PROFILER_GRAPH_HEIGHT 100 //pixels
+#define PROFILER_GRAPH_RANGE 50.0f //ms at the top of the graph
+
+bool Profiler::sEnabled = false;
+
+long long Profiler::sFrameStart = 0;
+long long Profiler::sPauseStart = 0;
+std::vector<Profiler::Scope> Profiler::sScopeStack;
+unsigned int Profiler::sCounters[COUNTER_COUNT];
+
+std::map<const char*, Profiler::ComponentStats> Profiler::sIntervalStats;
+std::map<const char*, Profiler::ComponentStats> Profiler::sTotalStats;
+unsigned long long Profiler::sIntervalCounters[COUNTER_COUNT];
+unsigned long long Profiler::sTotalCounters[COUNTER_COUNT];
+unsigned int Profiler::sIntervalFrames = 0;
+unsigned int Profiler::sTotalFrames = 0;
+long long Profiler::sIntervalStart = 0;
+
+float Profiler::sFrameHistory[PROFILER_HISTORY_SIZE];
+unsigned int Profiler::sFrameHistoryCount = 0;
+FrameTimeStats Profiler::sTotalFrameTimes;
+
+std::vector<std::string> Profiler::sOverlayText;
+bool Profiler::sOverlayChanged = false;
+
+void Profiler::setEnabled(bool enabled)
+{
+	sEnabled = enabled;
+
+	memset(sCounters, 0, sizeof(sCounters));
+	memset(sIntervalCounters, 0, sizeof(sIntervalCounters));
+	sIntervalStart = now();
+}
+
+long long Profiler::now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::beginFrame()
+{
+	if(!sEnabled)
+		return;
+
+	sFrameStart = now();
+	memset(sCounters, 0, sizeof(sCounters));
+}
+
+void Profiler::pauseFrame()
+{
+	if(sEnabled)
+		sPauseStart = now();
+}
+
+void Profiler::resumeFrame()
+{
+	if(sEnabled)
+		sFrameStart += now() - sPauseStart;
+}
+
+void Profiler::endFrame(bool rendered)
+{
+	if(!sEnabled)
+		return;
+
+	const long long end = now();
+
+	for(int i = 0; i < COUNTER_COUNT; i++)
+	{
+		sIntervalCounters[i] += sCounters[i];
+		sTotalCounters[i] += sCounters[i];
+	}
+
+	if(rendered)
+	{
+		const float ms = (end - sFrameStart) / 1000.0f;
+		sFrameHistory[sFrameHistoryCount % PROFILER_HISTORY_SIZE] = ms;
+		sFrameHistoryCount++;
+		sTotalFrameTimes.add(ms);
+		sIntervalFrames++;
+		sTotalFrames++;
+	}
+
+	if(end - sIntervalStart >= PROFILER_REFRESH_TIME * 1000)
+		refreshOverlay();
+}
+
+void Profiler::beginScope(const GuiComponent* component, Phase phase)
+{
+	Scope scope;
+	scope.type = typeid(*component).name();
+	scope.phase = phase;
+	scope.childTime = 0;
+	scope.start = now();
+	sScopeStack.push_back(scope);
+}
+
+void Profiler::endScope()
+{
+	const Scope& scope = sScopeStack.back();
+	const long long time = now() - scope.start;
+	const long long self = time - scope.childTime;
+
+	ComponentStats& interval = sIntervalStats[scope.type];
+	interval.time[scope.phase] += self;
+	interval.calls[scope.phase]++;
+
+	ComponentStats& total = sTotalStats[scope.type];
+	total.time[scope.phase] += self;
+	total.calls[scope.phase]++;
+
+	sScopeStack.pop_back();
+	if(!sScopeStack.empty())
+		sScopeStack.back().childTime += time;
+}
+
+std::string Profiler::getTypeName(const char* mangled)
+{
+#ifdef __GNUC__
+	int status = 0;
+	char* demangled = abi::__cxa_demangle(mangled, NULL, NULL, &status);
+	if(status == 0 && demangled != NULL)
+	{
+		std::string name = demangled;
+		free(demangled);
+		return name;
+	}
+#endif
+	//MSVC names are readable already ("class GuiGameList")
+	std::string name = mangled;
+	if(name.compare(0, 6, "class ") == 0)
+		name = name.substr(6);
+	return name;
+}
+
+std::vector<float> Profiler::getPercentiles(const std::vector<float>& percents)
+{
+	std::vector<float> result(percents.size(), 0.0f);
+
+	const unsigned int count = std::min(sFrameHistoryCount, (unsigned int)PROFILER_HISTORY_SIZE);
+	if(count == 0)
+		return result;
+
+	std::vector<float> sorted(sFrameHistory, sFrameHistory + count);
+	std::sort(sorted.begin(), sorted.end());
+
+	for(unsigned int i = 0; i < percents.size(); i++)
+	{
+		unsigned int index = (unsigned int)(percents.at(i) / 100.0f * count);
+		if(index >= count)
+			index = count - 1;
+		result[i] = sorted.at(index);
+	}
+
+	return result;
+}
+
+void Profiler::refreshOverlay()
+{
+	const long long end = now();
+	const unsigned int frames = std::max(sIntervalFrames, 1u);
+
+	sOverlayText.clear();
+
+	std::vector<float> percents;
+	percents.push_back(50);
+	percents.push_back(90);
+	percents.push_back(99);
+	percents.push_back(100);
+	const std::vector<float> frameTimes = getPercentiles(percents);
+
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2) << "frame ms  p50 " << frameTimes[0] << "  p90 " << frameTimes[1] << "  p99 " << frameTimes[2] << "  max " << frameTimes[3];
+	sOverlayText.push_back(ss.str());
+
+	ss.str("");
+	ss << std::fixed << std::setprecision(1) << "per frame  " << (float)sIntervalCounters[COUNTER_DRAW_CALLS] / frames << " draw calls, "
+		<< (float)sIntervalCounters[COUNTER_TEXTURE_BINDS] / frames << " texture binds, " << sIntervalCounters[COUNTER_TEXTURE_UPLOADS] << " uploads in "
+		<< sIntervalFrames << " frames";
+	sOverlayText.push_back(ss.str());
+
+	//slowest component classes first, by update + render time per frame
+	std::vector< std::pair<long long, const char*> > order;
+	for(auto it = sIntervalStats.begin(); it != sIntervalStats.end(); it++)
+		order.push_back(std::make_pair(it->second.time[PHASE_UPDATE] + it->second.time[PHASE_RENDER], it->first));
+	std::sort(order.rbegin(), order.rend());
+
+	for(unsigned int i = 0; i < order.size() && i < PROFILER_OVERLAY_COMPONENTS; i++)
+	{
+		const ComponentStats& stats = sIntervalStats[order.at(i).second];
+		ss.str("");
+		ss << std::fixed << std::setprecision(3) << "update " << stats.time[PHASE_UPDATE] / 1000.0f / frames << "ms  render " << stats.time[PHASE_RENDER] / 1000.0f / frames
+			<< "ms  " << getTypeName(order.at(i).second);
+		sOverlayText.push_back(ss.str());
+	}
+
+	sIntervalStats.clear();
+	memset(sIntervalCounters, 0, sizeof(sIntervalCounters));
+	sIntervalFrames = 0;
+	sIntervalStart = end;
+	sOverlayChanged = true;
+}
+
+bool Profiler::hasNewOverlay()
+{
+	const bool changed = sOverlayChanged;
+	sOverlayChanged = false;
+	return changed;
+}
+
+void Profiler::drawOverlay(Font& font)
+{
+	//the overlay's own drawing shouldn't show up in the numbers
+	unsigned int counters[COUNTER_COUNT];
+	memcpy(counters, sCounters, sizeof(counters));
+
+	const int x = 50;
+	const int y = 80;
+	const int lineHeight = font.getHeight();
+	const int width = PROFILER_HISTORY_SIZE * 2;
+	const int height = sOverlayText.size() * lineHeight + PROFILER_GRAPH_HEIGHT + 10;
+
+	Renderer::setMatrix(Eigen::Affine3f::Identity());
+	Renderer::drawRect(x - 5, y - 5, width + 10, height + 10, 0x000000A0);
+
+	for(unsigned int i = 0; i < sOverlayText.size(); i++)
+		font.drawText(sOverlayText.at(i), Eigen::Vector2f((float)x, (float)(y + i * lineHeight)), 0xFFFFFFFF);
+
+	//frame time graph, oldest frame on the left. one bar per frame, green up to 60fps, yellow up to 30fps, red above
+	const unsigned int count = std::min(sFrameHistoryCount, (unsigned int)PROFILER_HISTORY_SIZE);
+	const float bottom = (float)(y + height);
+	std::vector<Renderer::Vertex> verts(count * 6);
+	for(unsigned int i = 0; i < count; i++)
+	{
+		const float ms = sFrameHistory[(sFrameHistoryCount - count + i) % PROFILER_HISTORY_SIZE];
+		const float barHeight = std::min(ms / PROFILER_GRAPH_RANGE, 1.0f) * PROFILER_GRAPH_HEIGHT;
+		const float left = (float)(x + i * 2);
+		const float right = left + 2;
+		const float top = bottom - std::max(barHeight, 1.0f);
+
+		unsigned int color = 0x00FF00FF;
+		if(ms > 1000.0f / 30.0f)
+			color = 0xFF0000FF;
+		else if(ms > 1000.0f / 60.0f)
+			color = 0xFFFF00FF;
+
+		const float corners[6][2] = { { left, top }, { left, bottom }, { right, top }, { right, top }, { left, bottom }, { right, bottom } };
+		for(int v = 0; v < 6; v++)
+		{
+			Renderer::Vertex& vert = verts[i * 6 + v];
+			vert.pos[0] = corners[v][0];
+			vert.pos[1] = corners[v][1];
+			vert.tex[0] = 0;
+			vert.tex[1] = 0;
+			Renderer::buildGLColorArray(vert.color, color, 1);
+		}
+	}
+
+	if(count > 0)
+	{
+		Renderer::flushQuads();
+		Renderer::uploadVertices(verts.data(), verts.size());
+		Renderer::drawVertices(0, verts.size(), Renderer::DRAW_COLORED, 0, false);
+	}
+
+	//16.7ms line
+	Renderer::drawRect(x, (int)(bottom - (1000.0f / 60.0f) / PROFILER_GRAPH_RANGE * PROFILER_GRAPH_HEIGHT), width, 1, 0xFFFFFF80);
+
+	memcpy(sCounters, counters, sizeof(counters));
+}
+
+bool Profiler::writeReport(const std::string& path)
+{
+	std::ofstream file(path.c_str());
+	if(!file.is_open())
+	{
+		LOG(LogError) << "Could not write profile to \"" << path << "\"!";
+		return false;
+	}
+
+	const unsigned int frames = std::max(sTotalFrames, 1u);
+
+	file << "#EmulationStation profile. Times are in ms, components are timed without their children.\n";
+	file << "frames\t" << sTotalFrames << "\n";
+	file << std::fixed << std::setprecision(3);
+	file << "frame_ms_p50\t" << sTotalFrameTimes.getPercentile(50) << "\n";
+	file << "frame_ms_p90\t" << sTotalFrameTimes.getPercentile(90) << "\n";
+	file << "frame_ms_p95\t" << sTotalFrameTimes.getPercentile(95) << "\n";
+	file << "frame_ms_p99\t" << sTotalFrameTimes.getPercentile(99) << "\n";
+	file << "frame_ms_max\t" << sTotalFrameTimes.getPercentile(100) << "\n";
+	file << "draw_calls_per_frame\t" << (float)sTotalCounters[COUNTER_DRAW_CALLS] / frames << "\n";
+	file << "texture_binds_per_frame\t" << (float)sTotalCounters[COUNTER_TEXTURE_BINDS] / frames << "\n";
+	file << "texture_uploads\t" << sTotalCounters[COUNTER_TEXTURE_UPLOADS] << "\n";
+	file << "\n";
+
+	file << "component\tupdate_ms\tupdate_calls\trender_ms\trender_calls\n";
+	for(auto it = sTotalStats.begin(); it != sTotalStats.end(); it++)
+	{
+		file << getTypeName(it->first) << "\t" << it->second.time[PHASE_UPDATE] / 1000.0f << "\t" << it->second.calls[PHASE_UPDATE]
+			<< "\t" << it->second.time[PHASE_RENDER] / 1000.0f << "\t" << it->second.calls[PHASE_RENDER] << "\n";
+	}
+
+	LOG(LogInfo) << "Wrote profile to \"" << path << "\".";
+	return true;
+}
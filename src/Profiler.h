@@ -0,0 +1,122 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include "FrameTimeStats.h"
+
+class GuiComponent;
+class Font;
+
+#define PROFILER_HISTORY_SIZE 240 //rendered frames kept for the frame time graph and the percentiles
+#define PROFILER_REFRESH_TIME 500 //ms between overlay updates, same as the framerate display
+
+//Frame profiler, enabled with --profile. Everything here is only used from the main thread.
+//Times update() and render() of every GuiComponent class reached through the GuiComponent child lists (see ProfileScope),
+//and counts draw calls, texture binds and texture uploads. Component times are self times: the time spent in child
+//components that are timed themselves is subtracted from the parent.
+//Window draws the numbers as an overlay with a frame time graph, and main() writes a summary of the whole session to
+//the file given with --profile-file on exit.
+class Profiler
+{
+public:
+	enum Phase
+	{
+		PHASE_UPDATE,
+		PHASE_RENDER,
+		PHASE_COUNT
+	};
+
+	enum Counter
+	{
+		COUNTER_DRAW_CALLS,
+		COUNTER_TEXTURE_BINDS,
+		COUNTER_TEXTURE_UPLOADS,
+		COUNTER_COUNT
+	};
+
+	static void setEnabled(bool enabled);
+	static inline bool isEnabled() { return sEnabled; }
+
+	//One tick of the main loop. Only ticks that rendered end up in the frame time history.
+	static void beginFrame();
+	static void endFrame(bool rendered);
+
+	//Time between these doesn't count towards the frame (the buffer swap, which mostly waits for the display).
+	static void pauseFrame();
+	static void resumeFrame();
+
+	static void beginScope(const GuiComponent* component, Phase phase);
+	static void endScope();
+
+	static inline void count(Counter counter) { if(sEnabled) sCounters[counter]++; }
+
+	//True if the numbers shown by drawOverlay() changed since the last call, the window has to be redrawn then.
+	static bool hasNewOverlay();
+	static void drawOverlay(Font& font);
+
+	static bool writeReport(const std::string& path);
+
+private:
+	struct ComponentStats
+	{
+		long long time[PHASE_COUNT]; //microseconds
+		unsigned int calls[PHASE_COUNT];
+	};
+
+	struct Scope
+	{
+		const char* type;
+		Phase phase;
+		long long start;
+		long long childTime;
+	};
+
+	static long long now(); //microseconds
+	static std::string getTypeName(const char* mangled);
+	static std::vector<float> getPercentiles(const std::vector<float>& percents);
+	static void refreshOverlay();
+
+	static bool sEnabled;
+
+	static long long sFrameStart;
+	static long long sPauseStart;
+	static std::vector<Scope> sScopeStack;
+	static unsigned int sCounters[COUNTER_COUNT]; //current tick
+
+	//since the last overlay refresh, and for the whole session
+	static std::map<const char*, ComponentStats> sIntervalStats;
+	static std::map<const char*, ComponentStats> sTotalStats;
+	static unsigned long long sIntervalCounters[COUNTER_COUNT];
+	static unsigned long long sTotalCounters[COUNTER_COUNT];
+	static unsigned int sIntervalFrames;
+	static unsigned int sTotalFrames;
+	static long long sIntervalStart;
+
+	static float sFrameHistory[PROFILER_HISTORY_SIZE]; //ms, a ring buffer
+	static unsigned int sFrameHistoryCount;
+	static FrameTimeStats sTotalFrameTimes; //every rendered frame, for the report
+
+	static std::vector<std::string> sOverlayText;
+	static bool sOverlayChanged;
+};
+
+//Times the enclosed update() or render() call of component. Does nothing if the profiler is disabled.
+class ProfileScope
+{
+public:
+	inline ProfileScope(const GuiComponent* component, Profiler::Phase phase) : mActive(Profiler::isEnabled())
+	{
+		if(mActive)
+			Profiler::beginScope(component, phase);
+	}
+
+	inline ~ProfileScope()
+	{
+		if(mActive)
+			Profiler::endScope();
+	}
+
+private:
+	bool mActive;
+};
@@ -12,16 +12,22 @@ class GuiComponent;
 class Font;
 
 //The Renderer provides several higher-level functions for drawing (rectangles, text, etc.).
-//Defined in multiple files - Renderer.cpp has the GuiComponent stuff, Renderer_draw_* includes renderer-specific drawing implementations, and Renderer_init_* includes renderer-specific init/deinit.
+//Defined in multiple files - Renderer_draw_gl.cpp has the drawing functions, Renderer_state_gl.cpp the GL state cache, Renderer_pipeline_* the
+//pipeline-specific drawing backend (see below), Renderer_commands.cpp the command recorder, and Renderer_init_* includes renderer-specific init/deinit.
 namespace Renderer
 {
 	bool init(int w, int h);
 	void deinit();
 
-	//doesn't do anything right now
+	//called by init()/deinit() once the GL context exists/before it is destroyed
 	void onInit();
 	void onDeinit();
 
+#ifdef USE_OPENGL_DESKTOP
+	//Looks up a GL function of the current context, for GLExtensions. Comes from the window system, so it's in Renderer_init_*.
+	void* getProcAddress(const char* name);
+#endif
+
 	unsigned int getScreenWidth();
 	unsigned int getScreenHeight();
 
@@ -37,6 +43,139 @@ namespace Renderer
 	void setMatrix(const Eigen::Affine3f& transform);
 
 	void drawRect(int x, int y, int w, int h, unsigned int color);
+
+	//Redirects drawing into a framebuffer object (see TextureResource::initAsRenderTarget()), which is cleared first.
+	//0 switches back to the screen. Render targets are the size of the screen, so the projection stays the same.
+	void bindRenderTarget(GLuint framebuffer);
+
+	//Textured quad batching.
+	//Quads are transformed by the current matrix on the CPU and collected instead of drawn right away. flushQuads() uploads
+	//everything into one streaming vertex buffer and issues one glDrawArrays per texture batch.
+	//A quad is added to an earlier batch with the same texture as long as nothing queued after that batch overlaps it,
+	//so the result is the same as drawing in order. Anything that draws with GL directly has to call flushQuads()
+	//first - drawRect, clip rects and text already do.
+	//points and texs are 6 vertices (two triangles) each, color is RGBA.
+	void drawTexturedQuad(GLuint texture, const GLfloat* points, const GLfloat* texs, unsigned int color);
+	void flushQuads();
+
+	struct Vertex;
+
+	//Queues a quad that's already transformed to screen space, for drawTexturedQuad() and executeCommands().
+	void queueQuad(GLuint texture, const Vertex* verts);
+
+	//Draws a run of glyphs (see Font::renderTextCache()) with the matrix from setMatrix(). Flushes the queued quads first.
+	void drawTextVertices(GLuint texture, const Vertex* verts, unsigned int count, float alphaCutoff);
+
+	void initQuadBatching();
+	void deinitQuadBatching();
+
+	//Drawing backend, the only part of the Renderer that depends on the GL pipeline. Everything that draws ends up here.
+	//Renderer_pipeline_fixed.cpp uses fixed-function GL 1.x / GLES 1.1 with the transform in the modelview matrix.
+	//Builds with USE_SHADERS (GLSystem "OpenGL ES 2", or GLShaders=ON for desktop GL 2.0+) use Renderer_pipeline_shader.cpp instead:
+	//one small shader per DrawMode, vertex buffers and the transform as a uniform. Renderer_init_* creates a matching context.
+	struct Vertex
+	{
+		GLfloat pos[2];
+		GLfloat tex[2];
+		GLubyte color[4]; //RGBA
+	};
+
+	enum DrawMode
+	{
+		DRAW_COLORED, //vertex colors only
+		DRAW_TEXTURED, //RGBA texture times vertex color
+		DRAW_TEXT //alpha texture (glyphs), colored by the vertex color
+	};
+
+	void initPipeline(); //called by onInit()
+	void deinitPipeline();
+
+	//Orthographic projection for the screen, (0, 0) is the top left corner. Called by Renderer_init_*.
+	void setProjection(int width, int height);
+
+	//Sets the transform for vertices that aren't in screen space (column major 4x4, only ever 2D). Use setMatrix() instead, it also
+	//keeps the matrix for drawTexturedQuad().
+	void loadMatrix(const float* matrix);
+
+	//Hands count vertices to GL for drawVertices(). They're copied into a vertex buffer if there is one, otherwise they're drawn
+	//from client memory and have to stay valid until the drawVertices() calls are done.
+	void uploadVertices(const Vertex* verts, unsigned int count);
+
+	//Draws count of the uploaded vertices, starting at first, as triangles with alpha blending. texture is ignored for DRAW_COLORED.
+	//Vertices are transformed by the matrix from loadMatrix() unless they're already in screenSpace.
+	//If alphaCutoff is > 0, texture is a distance field (text) with the outline at 0.5 * the text alpha. Fragments with less alpha
+	//are dropped, and opaque text (alphaCutoff 0.5) is drawn without blending so the glyphs are solid.
+	void drawVertices(unsigned int first, unsigned int count, DrawMode mode, GLuint texture, bool screenSpace, float alphaCutoff = 0.0f);
+
+	//Command recording.
+	//Between beginRecording() and endRecording() the drawing functions above append what they are asked to do to a CommandList:
+	//every textured quad (before batching), rect and text run, and the state changes in between - matrices, clip rects and
+	//render targets. If execute is false, nothing reaches GL, so the render code of components can be run and timed on a machine
+	//without a GPU (creating textures and fonts still needs a context, a headless build has one). executeCommands() draws a
+	//recorded list later, and passes that merge or drop commands can work on the list in between.
+	enum CommandType
+	{
+		COMMAND_QUAD, //6 screen space vertices (already transformed) with texture
+		COMMAND_RECT, //rect with color, drawn with the current matrix
+		COMMAND_TEXT, //count vertices with texture and alphaCutoff, drawn with the current matrix
+		COMMAND_SET_MATRIX,
+		COMMAND_PUSH_CLIP, //rect is the position and size passed to pushClipRect()
+		COMMAND_POP_CLIP,
+		COMMAND_RENDER_TARGET, //texture is the framebuffer
+		COMMAND_TYPE_COUNT
+	};
+
+	struct Command
+	{
+		CommandType type;
+		GLuint texture;
+		unsigned int color;
+		unsigned int first; //quads and text: index into CommandList::vertices. matrices: index into CommandList::matrices
+		unsigned int count;
+		int rect[4]; //x, y, w, h
+		float alphaCutoff;
+	};
+
+	struct CommandList
+	{
+		std::vector<Command> commands;
+		std::vector<Vertex> vertices;
+		std::vector<float> matrices; //16 floats each, column major
+
+		void clear(); //keeps the memory for the next recording
+		unsigned int getCount(CommandType type) const;
+	};
+
+	void beginRecording(CommandList* list, bool execute);
+	void endRecording();
+	void executeCommands(const CommandList& list);
+
+	//Used by the drawing functions. recordCommand() returns the new command to fill in, or NULL if nothing is being recorded.
+	//shouldExecute() is false while recording without executing.
+	Command* recordCommand(CommandType type);
+	unsigned int recordVertices(const Vertex* verts, unsigned int count); //returns the index of the first
+	unsigned int recordMatrix(const float* matrix);
+	bool shouldExecute();
+
+	//GL state cache.
+	//Drawing code sets the state it needs through these and leaves it set afterwards, calls that wouldn't change anything
+	//are skipped. Everything that binds or deletes textures has to go through here as well, so the cache stays in sync with GL.
+	void setEnabled(GLenum capability, bool enabled); //GL_BLEND and GL_SCISSOR_TEST are cached, and GL_TEXTURE_2D and GL_ALPHA_TEST without shaders
+#ifndef USE_SHADERS
+	void setClientStateEnabled(GLenum array, bool enabled); //GL_VERTEX_ARRAY, GL_TEXTURE_COORD_ARRAY and GL_COLOR_ARRAY are cached
+#endif
+	void setBlendFunc(GLenum sfactor, GLenum dfactor);
+	void bindTexture(GLuint texture); //GL_TEXTURE_2D
+	void deleteTexture(GLuint texture);
+
+	//Puts GL into a known state (everything cached disabled, texture 0 bound, regular alpha blending) and syncs the cache with it.
+	//Called by onInit(), the state of a new context isn't what the cache remembers.
+	void resetState();
+
+	//State changes passed on to GL and skipped as redundant in the last frame. endStateFrame() is called by swapBuffers().
+	unsigned int getStateChangeCount();
+	unsigned int getSavedStateChangeCount();
+	void endStateFrame();
 }
 
 #endif
@@ -0,0 +1,123 @@
+#include "Renderer.h"
+#include "Log.h"
+
+//command recording, see Renderer.h
+namespace Renderer {
+	CommandList* recordingList = NULL;
+	bool executeWhileRecording = true;
+
+	void CommandList::clear()
+	{
+		commands.clear();
+		vertices.clear();
+		matrices.clear();
+	}
+
+	unsigned int CommandList::getCount(CommandType type) const
+	{
+		unsigned int count = 0;
+		for(unsigned int i = 0; i < commands.size(); i++)
+		{
+			if(commands[i].type == type)
+				count++;
+		}
+		return count;
+	}
+
+	void beginRecording(CommandList* list, bool execute)
+	{
+		if(recordingList != NULL)
+			LOG(LogWarning) << "Started recording render commands while already recording!";
+
+		recordingList = list;
+		executeWhileRecording = execute;
+	}
+
+	void endRecording()
+	{
+		recordingList = NULL;
+		executeWhileRecording = true;
+	}
+
+	void executeCommands(const CommandList& list)
+	{
+		//executing must not record into the list being read
+		CommandList* const recording = recordingList;
+		const bool executing = executeWhileRecording;
+		recordingList = NULL;
+		executeWhileRecording = true;
+
+		for(unsigned int i = 0; i < list.commands.size(); i++)
+		{
+			const Command& command = list.commands[i];
+			switch(command.type)
+			{
+			case COMMAND_QUAD:
+				queueQuad(command.texture, &list.vertices[command.first]);
+				break;
+			case COMMAND_RECT:
+				drawRect(command.rect[0], command.rect[1], command.rect[2], command.rect[3], command.color);
+				break;
+			case COMMAND_TEXT:
+				drawTextVertices(command.texture, &list.vertices[command.first], command.count, command.alphaCutoff);
+				break;
+			case COMMAND_SET_MATRIX:
+				setMatrix(const_cast<float*>(&list.matrices[command.first]));
+				break;
+			case COMMAND_PUSH_CLIP:
+				pushClipRect(Eigen::Vector2i(command.rect[0], command.rect[1]), Eigen::Vector2i(command.rect[2], command.rect[3]));
+				break;
+			case COMMAND_POP_CLIP:
+				popClipRect();
+				break;
+			case COMMAND_RENDER_TARGET:
+				bindRenderTarget(command.texture);
+				break;
+			default:
+				break;
+			}
+		}
+
+		flushQuads();
+
+		recordingList = recording;
+		executeWhileRecording = executing;
+	}
+
+	Command* recordCommand(CommandType type)
+	{
+		if(recordingList == NULL)
+			return NULL;
+
+		Command command;
+		command.type = type;
+		command.texture = 0;
+		command.color = 0;
+		command.first = 0;
+		command.count = 0;
+		command.rect[0] = command.rect[1] = command.rect[2] = command.rect[3] = 0;
+		command.alphaCutoff = 0.0f;
+
+		recordingList->commands.push_back(command);
+		return &recordingList->commands.back();
+	}
+
+	unsigned int recordVertices(const Vertex* verts, unsigned int count)
+	{
+		const unsigned int first = recordingList->vertices.size();
+		recordingList->vertices.insert(recordingList->vertices.end(), verts, verts + count);
+		return first;
+	}
+
+	unsigned int recordMatrix(const float* matrix)
+	{
+		const unsigned int first = recordingList->matrices.size();
+		recordingList->matrices.insert(recordingList->matrices.end(), matrix, matrix + 16);
+		return first;
+	}
+
+	bool shouldExecute()
+	{
+		return recordingList == NULL || executeWhileRecording;
+	}
+};
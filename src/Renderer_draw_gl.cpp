@@ -5,11 +5,28 @@
 #include "Font.h"
 #include <boost/filesystem.hpp>
 #include "Log.h"
+#include "GLExtensions.h"
 #include <stack>
+#include <algorithm>
 
 namespace Renderer {
 	std::stack<Eigen::Vector4i> clipStack;
 
+	//the matrix last passed to setMatrix, queued quads are transformed with it
+	Eigen::Matrix4f currentMatrix = Eigen::Matrix4f::Identity();
+
+	struct QuadBatch
+	{
+		GLuint texture;
+		std::vector<Vertex> verts;
+		Eigen::Vector4f bounds; //screen space x1, y1, x2, y2 of everything in the batch
+	};
+
+	//batches are reused between flushes to keep their vertex memory around, only the first batchCount are in use
+	std::vector<QuadBatch> quadBatches;
+	unsigned int batchCount = 0;
+	std::vector<Vertex> quadVertexData;
+
 	void setColor4bArray(GLubyte* array, unsigned int color)
 	{
 		array[0] = (color & 0xff000000) >> 24;
@@ -33,6 +50,18 @@ namespace Renderer {
 
 	void pushClipRect(Eigen::Vector2i pos, Eigen::Vector2i dim)
 	{
+		if(Command* command = recordCommand(COMMAND_PUSH_CLIP))
+		{
+			command->rect[0] = pos.x();
+			command->rect[1] = pos.y();
+			command->rect[2] = dim.x();
+			command->rect[3] = dim.y();
+		}
+		if(!shouldExecute())
+			return;
+
+		flushQuads();
+
 		Eigen::Vector4i box(pos.x(), pos.y(), dim.x(), dim.y());
 		if(box[2] == 0)
 			box[2] = Renderer::getScreenWidth() - box.x();
@@ -49,72 +78,234 @@ namespace Renderer {
 
 		clipStack.push(box);
 		glScissor(box[0], box[1], box[2], box[3]);
-		glEnable(GL_SCISSOR_TEST);
+		setEnabled(GL_SCISSOR_TEST, true);
 	}
 
 	void popClipRect()
 	{
+		recordCommand(COMMAND_POP_CLIP);
+		if(!shouldExecute())
+			return;
+
 		if(clipStack.empty())
 		{
 			LOG(LogError) << "Tried to popClipRect while the stack was empty!";
 			return;
 		}
 
+		flushQuads();
+
 		clipStack.pop();
 		if(clipStack.empty())
 		{
-			glDisable(GL_SCISSOR_TEST);
+			setEnabled(GL_SCISSOR_TEST, false);
 		}else{
 			Eigen::Vector4i top = clipStack.top();
 			glScissor(top[0], top[1], top[2], top[3]);
 		}
 	}
 
-	void drawRect(int x, int y, int w, int h, unsigned int color)
+	void bindRenderTarget(GLuint framebuffer)
 	{
-#ifdef USE_OPENGL_ES
-		GLshort points[12];
-#else
-		GLint points[12];
-#endif
+		if(Command* command = recordCommand(COMMAND_RENDER_TARGET))
+			command->texture = framebuffer;
+		if(!shouldExecute())
+			return;
 
-		points[0] = x; points [1] = y;
-		points[2] = x; points[3] = y + h;
-		points[4] = x + w; points[5] = y;
+		//whatever was queued belongs to the old target
+		flushQuads();
 
-		points[6] = x + w; points[7] = y;
-		points[8] = x; points[9] = y + h;
-		points[10] = x + w; points[11] = y + h;
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+		//same clear color as the screen
+		if(framebuffer != 0)
+			glClear(GL_COLOR_BUFFER_BIT);
+	}
 
-		GLubyte colors[6*4];
-		buildGLColorArray(colors, color, 6);
+	void drawRect(int x, int y, int w, int h, unsigned int color)
+	{
+		if(Command* command = recordCommand(COMMAND_RECT))
+		{
+			command->rect[0] = x;
+			command->rect[1] = y;
+			command->rect[2] = w;
+			command->rect[3] = h;
+			command->color = color;
+		}
+		if(!shouldExecute())
+			return;
 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glEnableClientState(GL_COLOR_ARRAY);
+		flushQuads();
 
-#ifdef USE_OPENGL_ES
-		glVertexPointer(2, GL_SHORT, 0, points);
-#else
-		glVertexPointer(2, GL_INT, 0, points);
-#endif
-		glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors);
+		Vertex verts[6];
+		verts[0].pos[0] = (GLfloat)x; verts[0].pos[1] = (GLfloat)y;
+		verts[1].pos[0] = (GLfloat)x; verts[1].pos[1] = (GLfloat)(y + h);
+		verts[2].pos[0] = (GLfloat)(x + w); verts[2].pos[1] = (GLfloat)y;
 
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		verts[3].pos[0] = (GLfloat)(x + w); verts[3].pos[1] = (GLfloat)y;
+		verts[4].pos[0] = (GLfloat)x; verts[4].pos[1] = (GLfloat)(y + h);
+		verts[5].pos[0] = (GLfloat)(x + w); verts[5].pos[1] = (GLfloat)(y + h);
 
-		glDisableClientState(GL_BLEND);
-		glDisableClientState(GL_VERTEX_ARRAY);
-		glDisable(GL_COLOR_ARRAY);
+		for(int i = 0; i < 6; i++)
+		{
+			verts[i].tex[0] = 0;
+			verts[i].tex[1] = 0;
+			setColor4bArray(verts[i].color, color);
+		}
+
+		uploadVertices(verts, 6);
+		drawVertices(0, 6, DRAW_COLORED, 0, false);
 	}
 
 	void setMatrix(float* matrix)
 	{
-		glLoadMatrixf(matrix);
+		//kept even when not executing, drawTexturedQuad() transforms with it
+		currentMatrix = Eigen::Map<Eigen::Matrix4f>(matrix);
+
+		if(Command* command = recordCommand(COMMAND_SET_MATRIX))
+			command->first = recordMatrix(matrix);
+		if(!shouldExecute())
+			return;
+
+		loadMatrix(matrix);
 	}
 
 	void setMatrix(const Eigen::Affine3f& matrix)
 	{
 		setMatrix((float*)matrix.data());
 	}
+
+	void initQuadBatching()
+	{
+		GLExtensions::init();
+		initPipeline();
+	}
+
+	void deinitQuadBatching()
+	{
+		batchCount = 0;
+		deinitPipeline();
+	}
+
+	bool boundsOverlap(const Eigen::Vector4f& a, const Eigen::Vector4f& b)
+	{
+		return a[0] < b[2] && b[0] < a[2] && a[1] < b[3] && b[1] < a[3];
+	}
+
+	void drawTexturedQuad(GLuint texture, const GLfloat* points, const GLfloat* texs, unsigned int color)
+	{
+		if(texture == 0)
+		{
+			LOG(LogError) << "Tried to draw uninitialized texture!";
+			return;
+		}
+
+		Vertex verts[6];
+		for(int i = 0; i < 6; i++)
+		{
+			//only 2D transforms are ever used, so skip z and w
+			const float x = points[i * 2];
+			const float y = points[i * 2 + 1];
+			verts[i].pos[0] = currentMatrix(0, 0) * x + currentMatrix(0, 1) * y + currentMatrix(0, 3);
+			verts[i].pos[1] = currentMatrix(1, 0) * x + currentMatrix(1, 1) * y + currentMatrix(1, 3);
+			verts[i].tex[0] = texs[i * 2];
+			verts[i].tex[1] = texs[i * 2 + 1];
+			setColor4bArray(verts[i].color, color);
+		}
+
+		if(Command* command = recordCommand(COMMAND_QUAD))
+		{
+			command->texture = texture;
+			command->first = recordVertices(verts, 6);
+			command->count = 6;
+		}
+		if(!shouldExecute())
+			return;
+
+		queueQuad(texture, verts);
+	}
+
+	void queueQuad(GLuint texture, const Vertex* verts)
+	{
+		Eigen::Vector4f bounds(verts[0].pos[0], verts[0].pos[1], verts[0].pos[0], verts[0].pos[1]);
+		for(int i = 1; i < 6; i++)
+		{
+			bounds[0] = std::min(bounds[0], verts[i].pos[0]);
+			bounds[1] = std::min(bounds[1], verts[i].pos[1]);
+			bounds[2] = std::max(bounds[2], verts[i].pos[0]);
+			bounds[3] = std::max(bounds[3], verts[i].pos[1]);
+		}
+
+		//find the newest batch with this texture we can join without changing the draw order of overlapping quads
+		int target = -1;
+		for(int i = (int)batchCount - 1; i >= 0; i--)
+		{
+			if(quadBatches[i].texture == texture)
+			{
+				target = i;
+				break;
+			}
+
+			if(boundsOverlap(quadBatches[i].bounds, bounds))
+				break;
+		}
+
+		if(target == -1)
+		{
+			if(batchCount == quadBatches.size())
+				quadBatches.push_back(QuadBatch());
+
+			target = batchCount++;
+			quadBatches[target].texture = texture;
+			quadBatches[target].verts.clear();
+			quadBatches[target].bounds = bounds;
+		}
+
+		QuadBatch& batch = quadBatches[target];
+		batch.verts.insert(batch.verts.end(), verts, verts + 6);
+		batch.bounds << std::min(batch.bounds[0], bounds[0]), std::min(batch.bounds[1], bounds[1]),
+			std::max(batch.bounds[2], bounds[2]), std::max(batch.bounds[3], bounds[3]);
+	}
+
+	void flushQuads()
+	{
+		if(batchCount == 0)
+			return;
+
+		//put all batches into one array, so there's just one upload
+		quadVertexData.clear();
+		for(unsigned int i = 0; i < batchCount; i++)
+			quadVertexData.insert(quadVertexData.end(), quadBatches[i].verts.begin(), quadBatches[i].verts.end());
+
+		uploadVertices(quadVertexData.data(), quadVertexData.size());
+
+		//vertices are already in screen space
+		unsigned int first = 0;
+		for(unsigned int i = 0; i < batchCount; i++)
+		{
+			drawVertices(first, quadBatches[i].verts.size(), DRAW_TEXTURED, quadBatches[i].texture, true);
+			first += quadBatches[i].verts.size();
+		}
+
+		batchCount = 0;
+	}
+
+	void drawTextVertices(GLuint texture, const Vertex* verts, unsigned int count, float alphaCutoff)
+	{
+		if(Command* command = recordCommand(COMMAND_TEXT))
+		{
+			command->texture = texture;
+			command->first = recordVertices(verts, count);
+			command->count = count;
+			command->alphaCutoff = alphaCutoff;
+		}
+		if(!shouldExecute())
+			return;
+
+		//text is drawn immediately, so anything queued before it has to go first
+		flushQuads();
+
+		uploadVertices(verts, count);
+		drawVertices(0, count, DRAW_TEXT, texture, false, alphaCutoff);
+	}
 };
@@ -7,9 +7,12 @@ namespace Renderer
 {
 	void onInit()
 	{
+		resetState();
+		initQuadBatching();
 	}
 
 	void onDeinit()
 	{
+		deinitQuadBatching();
 	}
 };
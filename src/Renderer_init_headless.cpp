@@ -0,0 +1,139 @@
+#include "Renderer.h"
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include "platform.h"
+#include GLHEADER
+#include <GL/osmesa.h>
+
+#include "Font.h"
+#include <SDL.h>
+#include "InputManager.h"
+#include "Log.h"
+#include "Settings.h"
+
+//Offscreen renderer for machines without a display or GPU (build servers). Mesa's OSMesa renders with desktop GL into a
+//buffer in system memory. SDL still runs (with its dummy video driver) so timers and the event queue work as usual.
+namespace Renderer
+{
+	//used if no resolution was given with -w/-h, there's no screen to take it from
+	const unsigned int HEADLESS_DEFAULT_WIDTH = 1280;
+	const unsigned int HEADLESS_DEFAULT_HEIGHT = 720;
+
+	unsigned int display_width = 0;
+	unsigned int display_height = 0;
+
+	unsigned int getScreenWidth() { return display_width; }
+	unsigned int getScreenHeight() { return display_height; }
+
+	SDL_Surface* sdlScreen = NULL;
+	OSMesaContext context = NULL;
+	std::vector<unsigned char> frameBuffer;
+
+	bool createSurface()
+	{
+		LOG(LogInfo) << "Starting SDL without a display...";
+
+		//don't overwrite a driver set by the user
+		setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+		if(SDL_Init(SDL_INIT_VIDEO) != 0)
+		{
+			LOG(LogError) << "Error initializing SDL!\n	" << SDL_GetError();
+			return false;
+		}
+
+		if(display_width == 0)
+			display_width = HEADLESS_DEFAULT_WIDTH;
+		if(display_height == 0)
+			display_height = HEADLESS_DEFAULT_HEIGHT;
+
+		//SDL 1.2 only delivers events with a video surface. nothing is drawn to it
+		sdlScreen = SDL_SetVideoMode(1, 1, 0, SDL_SWSURFACE);
+		if(sdlScreen == NULL)
+		{
+			LOG(LogError) << "Error creating SDL surface for input!\n	" << SDL_GetError();
+			return false;
+		}
+
+		LOG(LogInfo) << "Creating offscreen surface...";
+
+		context = OSMesaCreateContextExt(OSMESA_RGBA, 16, 0, 0, NULL);
+		if(context == NULL)
+		{
+			LOG(LogError) << "Error creating OSMesa context!";
+			return false;
+		}
+
+		frameBuffer.resize(display_width * display_height * 4);
+		if(!OSMesaMakeCurrent(context, frameBuffer.data(), GL_UNSIGNED_BYTE, display_width, display_height))
+		{
+			LOG(LogError) << "Error making OSMesa context current!";
+			return false;
+		}
+
+		LOG(LogInfo) << "Created offscreen surface successfully (" << display_width << "x" << display_height << ", " << glGetString(GL_RENDERER) << ").";
+
+		return true;
+	}
+
+	void swapBuffers()
+	{
+		//there's nothing to show, but the frame has to be finished so its cost is measured where it happens
+		glFinish();
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		endStateFrame();
+	}
+
+	void destroySurface()
+	{
+		if(context != NULL)
+		{
+			OSMesaDestroyContext(context);
+			context = NULL;
+		}
+		std::vector<unsigned char>().swap(frameBuffer);
+
+		if(sdlScreen != NULL)
+		{
+			SDL_FreeSurface(sdlScreen);
+			sdlScreen = NULL;
+		}
+
+		SDL_Quit();
+	}
+
+	void* getProcAddress(const char* name)
+	{
+		return (void*)OSMesaGetProcAddress(name);
+	}
+
+	bool init(int w, int h)
+	{
+		if(w)
+			display_width = w;
+		if(h)
+			display_height = h;
+
+		bool createdSurface = createSurface();
+
+		if(!createdSurface)
+			return false;
+
+		glViewport(0, 0, display_width, display_height);
+
+		setProjection(display_width, display_height);
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+
+		onInit();
+
+		return true;
+	}
+
+	void deinit()
+	{
+		onDeinit();
+
+		destroySurface();
+	}
+};
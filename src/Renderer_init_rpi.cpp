@@ -1,13 +1,14 @@
 #include "Renderer.h"
 #include <iostream>
 #include "platform.h"
-#include <GLES/gl.h>
+#include GLHEADER
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 #include "Font.h"
 #include <SDL/SDL.h>
 #include "InputManager.h"
 #include "Log.h"
+#include "Settings.h"
 
 #ifdef _RPI_
     #include <bcm_host.h>
@@ -91,6 +92,9 @@ namespace Renderer
 			EGL_BLUE_SIZE, 8,
 			EGL_ALPHA_SIZE, 8,
 			EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
+#ifdef USE_OPENGL_ES2
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+#endif
 			EGL_NONE
 		};
 
@@ -104,7 +108,16 @@ namespace Renderer
 		}
 
 
+#ifdef USE_OPENGL_ES2
+		static const EGLint context_attributes[] =
+		{
+			EGL_CONTEXT_CLIENT_VERSION, 2,
+			EGL_NONE
+		};
+		context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attributes);
+#else
 		context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+#endif
 		if(context == EGL_NO_CONTEXT)
 		{
 			LOG(LogError) << "Error getting context!\n	" << eglGetError();
@@ -175,6 +188,10 @@ namespace Renderer
 		}
 
 
+		//vsync
+		if(eglSwapInterval(display, Settings::getInstance()->getBool("VSYNC") ? 1 : 0) == EGL_FALSE)
+			LOG(LogWarning) << "Could not set swap interval!";
+
 		LOG(LogInfo) << "Created surface successfully!";
 
 		return true;
@@ -184,6 +201,7 @@ namespace Renderer
 	{
 		eglSwapBuffers(display, surface);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		endStateFrame();
 	}
 
 	void destroySurface()
@@ -216,9 +234,7 @@ namespace Renderer
 			return false;
 
 		glViewport(0, 0, display_width, display_height);
-		glMatrixMode(GL_PROJECTION);
-		glOrthof(0, display_width, display_height, 0, -1.0, 1.0);
-		glMatrixMode(GL_MODELVIEW);
+		setProjection(display_width, display_height);
 		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 
 		onInit();
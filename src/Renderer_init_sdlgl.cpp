@@ -70,7 +70,7 @@ namespace Renderer
 		SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 8);
 		SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
 		SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-		//SDL_GL_SetAttribute(SDL_GL_SWAP_CONTROL, 1); //vsync
+		SDL_GL_SetAttribute(SDL_GL_SWAP_CONTROL, Settings::getInstance()->getBool("VSYNC") ? 1 : 0); //vsync
 		sdlScreen = SDL_SetVideoMode(display_width, display_height, 16, SDL_OPENGL | (Settings::getInstance()->getBool("WINDOWED") ? 0 : SDL_FULLSCREEN));
 
 		if(sdlScreen == NULL)
@@ -97,6 +97,7 @@ namespace Renderer
 	{
 		SDL_GL_SwapBuffers();
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		endStateFrame();
 	}
 
 	void destroySurface()
@@ -110,6 +111,11 @@ namespace Renderer
 		SDL_Quit();
 	}
 
+	void* getProcAddress(const char* name)
+	{
+		return SDL_GL_GetProcAddress(name);
+	}
+
 	bool init(int w, int h)
 	{
 		if(w)
@@ -124,9 +130,7 @@ namespace Renderer
 
 		glViewport(0, 0, display_width, display_height);
 
-		glMatrixMode(GL_PROJECTION);
-		glOrtho(0, display_width, display_height, 0, -1.0, 1.0);
-		glMatrixMode(GL_MODELVIEW);
+		setProjection(display_width, display_height);
 		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 
 		onInit();
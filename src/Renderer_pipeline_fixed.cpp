@@ -0,0 +1,105 @@
+#include "platform.h"
+#include "Renderer.h"
+#include GLHEADER
+#include "GLExtensions.h"
+#include "Profiler.h"
+#include <cstddef>
+#include <cstring>
+
+//fixed-function GL 1.x / GLES 1.1 drawing backend, see Renderer.h
+namespace Renderer {
+	GLuint vertexBuffer = 0;
+
+	//the modelview matrix is switched to identity for screen space vertices, and only restored when something else needs it
+	GLfloat modelMatrix[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+	bool identityLoaded = false;
+
+	void initPipeline()
+	{
+		if(GLExtensions::hasVertexBuffers())
+			glGenBuffers(1, &vertexBuffer);
+	}
+
+	void deinitPipeline()
+	{
+		if(vertexBuffer != 0)
+		{
+			glDeleteBuffers(1, &vertexBuffer);
+			vertexBuffer = 0;
+		}
+	}
+
+	void setProjection(int width, int height)
+	{
+		glMatrixMode(GL_PROJECTION);
+		glLoadIdentity();
+#ifdef USE_OPENGL_ES
+		glOrthof(0, (GLfloat)width, (GLfloat)height, 0, -1.0f, 1.0f);
+#else
+		glOrtho(0, width, height, 0, -1.0, 1.0);
+#endif
+		glMatrixMode(GL_MODELVIEW);
+	}
+
+	void loadMatrix(const float* matrix)
+	{
+		memcpy(modelMatrix, matrix, sizeof(modelMatrix));
+		glLoadMatrixf(modelMatrix);
+		identityLoaded = false;
+	}
+
+	void uploadVertices(const Vertex* verts, unsigned int count)
+	{
+		const GLubyte* base = NULL;
+		if(vertexBuffer != 0)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+#ifdef USE_OPENGL_ES
+			glBufferData(GL_ARRAY_BUFFER, count * sizeof(Vertex), verts, GL_DYNAMIC_DRAW);
+#else
+			glBufferData(GL_ARRAY_BUFFER, count * sizeof(Vertex), verts, GL_STREAM_DRAW);
+#endif
+		}else{
+			base = (const GLubyte*)verts;
+		}
+
+		glVertexPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, pos));
+		glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, tex));
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), base + offsetof(Vertex, color));
+	}
+
+	void drawVertices(unsigned int first, unsigned int count, DrawMode mode, GLuint texture, bool screenSpace, float alphaCutoff)
+	{
+		const bool textured = (mode != DRAW_COLORED);
+
+		//GL_MODULATE takes the color from the vertices and multiplies alpha for alpha textures, so text needs nothing special
+		setEnabled(GL_TEXTURE_2D, textured);
+		if(textured)
+			bindTexture(texture);
+
+		//distance field text has a field value of 0.5-1 inside the glyphs, not coverage. blending with it would make the glyphs
+		//translucent, so opaque text (cutoff 0.5) is only alpha tested. fading text still blends, it is translucent anyway
+		setEnabled(GL_BLEND, alphaCutoff < 0.5f);
+		setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		setEnabled(GL_ALPHA_TEST, alphaCutoff > 0);
+		if(alphaCutoff > 0)
+			glAlphaFunc(GL_GEQUAL, alphaCutoff);
+
+		setClientStateEnabled(GL_VERTEX_ARRAY, true);
+		setClientStateEnabled(GL_TEXTURE_COORD_ARRAY, textured);
+		setClientStateEnabled(GL_COLOR_ARRAY, true);
+
+		if(screenSpace != identityLoaded)
+		{
+			if(screenSpace)
+				glLoadIdentity();
+			else
+				glLoadMatrixf(modelMatrix);
+			identityLoaded = screenSpace;
+		}
+
+		Profiler::count(Profiler::COUNTER_DRAW_CALLS);
+		glDrawArrays(GL_TRIANGLES, first, count);
+	}
+};
@@ -0,0 +1,295 @@
+#include "platform.h"
+#include "Renderer.h"
+#include GLHEADER
+#include "GLExtensions.h"
+#include "Profiler.h"
+#include "Log.h"
+#include <cstddef>
+#include <vector>
+
+//shader drawing backend for GLES 2 and desktop GL 2.0+, see Renderer.h
+namespace Renderer {
+	//GLSL ES 1.00 and GLSL 1.10 - the latter doesn't know precision qualifiers
+	const char* vertexShaderSource =
+		"attribute vec2 aPosition;\n"
+		"attribute vec2 aTexCoord;\n"
+		"attribute vec4 aColor;\n"
+		"uniform mat4 uTransform;\n"
+		"varying vec2 vTexCoord;\n"
+		"varying vec4 vColor;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = uTransform * vec4(aPosition, 0.0, 1.0);\n"
+		"	vTexCoord = aTexCoord;\n"
+		"	vColor = aColor;\n"
+		"}\n";
+
+	//one per DrawMode
+	const char* fragmentShaderSources[] = {
+		//DRAW_COLORED
+		"#ifdef GL_ES\n"
+		"precision mediump float;\n"
+		"#endif\n"
+		"varying vec4 vColor;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_FragColor = vColor;\n"
+		"}\n",
+
+		//DRAW_TEXTURED
+		"#ifdef GL_ES\n"
+		"precision mediump float;\n"
+		"#endif\n"
+		"uniform sampler2D uTexture;\n"
+		"varying vec2 vTexCoord;\n"
+		"varying vec4 vColor;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_FragColor = vColor * texture2D(uTexture, vTexCoord);\n"
+		"}\n",
+
+		//DRAW_TEXT - glyphs only have alpha, like GL_MODULATE with an alpha texture. uAlphaCutoff > 0 means the texture is a distance
+		//field, which is turned into coverage over about a pixel around the outline (0.5) instead of being used as alpha directly
+		"#ifdef GL_ES\n"
+		"#ifdef GL_OES_standard_derivatives\n"
+		"#extension GL_OES_standard_derivatives : enable\n"
+		"#define HAVE_DERIVATIVES\n"
+		"#endif\n"
+		"precision mediump float;\n"
+		"#else\n"
+		"#define HAVE_DERIVATIVES\n"
+		"#endif\n"
+		"uniform sampler2D uTexture;\n"
+		"uniform float uAlphaCutoff;\n"
+		"varying vec2 vTexCoord;\n"
+		"varying vec4 vColor;\n"
+		"void main()\n"
+		"{\n"
+		"	float alpha = texture2D(uTexture, vTexCoord).a;\n"
+		"	if(uAlphaCutoff > 0.0)\n"
+		"	{\n"
+		"#ifdef HAVE_DERIVATIVES\n"
+		"		float w = max(0.5 * fwidth(alpha), 0.01);\n"
+		"#else\n"
+		"		float w = 0.1;\n"
+		"#endif\n"
+		"		alpha = smoothstep(0.5 - w, 0.5 + w, alpha);\n"
+		"	}\n"
+		"	gl_FragColor = vec4(vColor.rgb, vColor.a * alpha);\n"
+		"}\n"
+	};
+
+	const GLuint ATTRIB_POSITION = 0;
+	const GLuint ATTRIB_TEXCOORD = 1;
+	const GLuint ATTRIB_COLOR = 2;
+
+	struct Program
+	{
+		GLuint id;
+		GLint transformLocation;
+		GLint alphaCutoffLocation; //-1 if the shader doesn't have it
+		unsigned int transformSerial; //the transform last set, uniforms belong to the program so every one needs its own update
+		bool screenSpace;
+		float alphaCutoff;
+	};
+
+	Program programs[3];
+	int currentProgram = -1;
+	GLuint vertexBuffer = 0;
+
+	Eigen::Matrix4f projection = Eigen::Matrix4f::Identity();
+	Eigen::Matrix4f projectionModel = Eigen::Matrix4f::Identity(); //projection * the matrix from loadMatrix()
+	unsigned int transformSerial = 1; //changes whenever one of the above does
+
+	GLuint compileShader(GLenum type, const char* source)
+	{
+		GLuint shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, NULL);
+		glCompileShader(shader);
+
+		GLint status = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		if(status != GL_TRUE)
+		{
+			GLint length = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+			std::vector<char> log(length + 1, '\0');
+			glGetShaderInfoLog(shader, length, NULL, log.data());
+			LOG(LogError) << "Could not compile shader!\n	" << log.data();
+
+			glDeleteShader(shader);
+			return 0;
+		}
+
+		return shader;
+	}
+
+	bool linkProgram(Program& program, GLuint vertexShader, GLuint fragmentShader)
+	{
+		program.id = glCreateProgram();
+		glAttachShader(program.id, vertexShader);
+		glAttachShader(program.id, fragmentShader);
+
+		//fixed locations, so the attribute pointers are the same for every program
+		glBindAttribLocation(program.id, ATTRIB_POSITION, "aPosition");
+		glBindAttribLocation(program.id, ATTRIB_TEXCOORD, "aTexCoord");
+		glBindAttribLocation(program.id, ATTRIB_COLOR, "aColor");
+		glLinkProgram(program.id);
+
+		GLint status = GL_FALSE;
+		glGetProgramiv(program.id, GL_LINK_STATUS, &status);
+		if(status != GL_TRUE)
+		{
+			GLint length = 0;
+			glGetProgramiv(program.id, GL_INFO_LOG_LENGTH, &length);
+			std::vector<char> log(length + 1, '\0');
+			glGetProgramInfoLog(program.id, length, NULL, log.data());
+			LOG(LogError) << "Could not link shader program!\n	" << log.data();
+
+			glDeleteProgram(program.id);
+			program.id = 0;
+			return false;
+		}
+
+		program.transformLocation = glGetUniformLocation(program.id, "uTransform");
+		program.alphaCutoffLocation = glGetUniformLocation(program.id, "uAlphaCutoff");
+		program.transformSerial = 0;
+		program.screenSpace = false;
+		program.alphaCutoff = 0.0f;
+
+		//samplers default to texture unit 0 anyway, but some drivers are picky
+		const GLint textureLocation = glGetUniformLocation(program.id, "uTexture");
+		if(textureLocation != -1)
+		{
+			glUseProgram(program.id);
+			glUniform1i(textureLocation, 0);
+		}
+
+		return true;
+	}
+
+	void initPipeline()
+	{
+		currentProgram = -1;
+		for(int i = 0; i < 3; i++)
+			programs[i].id = 0;
+
+		if(!GLExtensions::hasShaders())
+		{
+			LOG(LogError) << "This build draws with shaders, but the GL driver doesn't support them (needs OpenGL 2.0 or OpenGL ES 2)!";
+			return;
+		}
+
+		GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSource);
+		if(vertexShader == 0)
+			return;
+
+		for(int i = 0; i < 3; i++)
+		{
+			GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSources[i]);
+			if(fragmentShader != 0)
+			{
+				linkProgram(programs[i], vertexShader, fragmentShader);
+				glDeleteShader(fragmentShader); //the program keeps it alive
+			}
+		}
+		glDeleteShader(vertexShader);
+
+		if(GLExtensions::hasVertexBuffers())
+			glGenBuffers(1, &vertexBuffer);
+
+		//there's only one vertex format, so the arrays stay enabled
+		glEnableVertexAttribArray(ATTRIB_POSITION);
+		glEnableVertexAttribArray(ATTRIB_TEXCOORD);
+		glEnableVertexAttribArray(ATTRIB_COLOR);
+	}
+
+	void deinitPipeline()
+	{
+		glUseProgram(0);
+		currentProgram = -1;
+
+		for(int i = 0; i < 3; i++)
+		{
+			if(programs[i].id != 0)
+			{
+				glDeleteProgram(programs[i].id);
+				programs[i].id = 0;
+			}
+		}
+
+		if(vertexBuffer != 0)
+		{
+			glDeleteBuffers(1, &vertexBuffer);
+			vertexBuffer = 0;
+		}
+	}
+
+	void setProjection(int width, int height)
+	{
+		//same as glOrtho(0, width, height, 0, -1, 1)
+		projection << 2.0f / width, 0, 0, -1.0f,
+			0, -2.0f / height, 0, 1.0f,
+			0, 0, -1.0f, 0,
+			0, 0, 0, 1.0f;
+		projectionModel = projection;
+		transformSerial++;
+	}
+
+	void loadMatrix(const float* matrix)
+	{
+		projectionModel = projection * Eigen::Map<const Eigen::Matrix4f>(matrix);
+		transformSerial++;
+	}
+
+	void uploadVertices(const Vertex* verts, unsigned int count)
+	{
+		const GLubyte* base = NULL;
+		if(vertexBuffer != 0)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+			glBufferData(GL_ARRAY_BUFFER, count * sizeof(Vertex), verts, GL_STREAM_DRAW);
+		}else{
+			base = (const GLubyte*)verts;
+		}
+
+		glVertexAttribPointer(ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, pos));
+		glVertexAttribPointer(ATTRIB_TEXCOORD, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, tex));
+		glVertexAttribPointer(ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), base + offsetof(Vertex, color));
+	}
+
+	void drawVertices(unsigned int first, unsigned int count, DrawMode mode, GLuint texture, bool screenSpace, float alphaCutoff)
+	{
+		Program& program = programs[mode];
+		if(program.id == 0)
+			return;
+
+		if(currentProgram != mode)
+		{
+			glUseProgram(program.id);
+			currentProgram = mode;
+		}
+
+		if(program.transformSerial != transformSerial || program.screenSpace != screenSpace)
+		{
+			glUniformMatrix4fv(program.transformLocation, 1, GL_FALSE, screenSpace ? projection.data() : projectionModel.data());
+			program.transformSerial = transformSerial;
+			program.screenSpace = screenSpace;
+		}
+
+		if(program.alphaCutoffLocation != -1 && program.alphaCutoff != alphaCutoff)
+		{
+			glUniform1f(program.alphaCutoffLocation, alphaCutoff);
+			program.alphaCutoff = alphaCutoff;
+		}
+
+		if(mode != DRAW_COLORED)
+			bindTexture(texture);
+
+		setEnabled(GL_BLEND, true);
+		setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		Profiler::count(Profiler::COUNTER_DRAW_CALLS);
+		glDrawArrays(GL_TRIANGLES, first, count);
+	}
+};
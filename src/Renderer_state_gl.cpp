@@ -0,0 +1,159 @@
+#include "platform.h"
+#include "Renderer.h"
+#include GLHEADER
+#include "Profiler.h"
+
+namespace Renderer {
+	//what we last told GL. only the capabilities and arrays we actually use are tracked
+#ifdef USE_SHADERS
+	const GLenum trackedCapabilities[] = { GL_BLEND, GL_SCISSOR_TEST }; //texturing and alpha testing are up to the shaders
+#else
+	const GLenum trackedCapabilities[] = { GL_TEXTURE_2D, GL_BLEND, GL_ALPHA_TEST, GL_SCISSOR_TEST };
+	const GLenum trackedClientStates[] = { GL_VERTEX_ARRAY, GL_TEXTURE_COORD_ARRAY, GL_COLOR_ARRAY };
+	const int clientStateCount = sizeof(trackedClientStates) / sizeof(trackedClientStates[0]);
+	bool clientStateEnabled[clientStateCount];
+#endif
+	const int capabilityCount = sizeof(trackedCapabilities) / sizeof(trackedCapabilities[0]);
+	bool capabilityEnabled[capabilityCount];
+	GLenum blendSrc = GL_ONE;
+	GLenum blendDst = GL_ZERO;
+	GLuint boundTexture = 0;
+
+	//counted since the last swapBuffers(), and for the frame before that
+	unsigned int stateChanges = 0;
+	unsigned int savedStateChanges = 0;
+	unsigned int lastFrameStateChanges = 0;
+	unsigned int lastFrameSavedStateChanges = 0;
+
+	int findIndex(const GLenum* list, int count, GLenum value)
+	{
+		for(int i = 0; i < count; i++)
+		{
+			if(list[i] == value)
+				return i;
+		}
+
+		return -1;
+	}
+
+	void setEnabled(GLenum capability, bool enabled)
+	{
+		const int index = findIndex(trackedCapabilities, capabilityCount, capability);
+		if(index != -1)
+		{
+			if(capabilityEnabled[index] == enabled)
+			{
+				savedStateChanges++;
+				return;
+			}
+			capabilityEnabled[index] = enabled;
+		}
+
+		stateChanges++;
+		if(enabled)
+			glEnable(capability);
+		else
+			glDisable(capability);
+	}
+
+#ifndef USE_SHADERS
+	void setClientStateEnabled(GLenum array, bool enabled)
+	{
+		const int index = findIndex(trackedClientStates, clientStateCount, array);
+		if(index != -1)
+		{
+			if(clientStateEnabled[index] == enabled)
+			{
+				savedStateChanges++;
+				return;
+			}
+			clientStateEnabled[index] = enabled;
+		}
+
+		stateChanges++;
+		if(enabled)
+			glEnableClientState(array);
+		else
+			glDisableClientState(array);
+	}
+#endif
+
+	void setBlendFunc(GLenum sfactor, GLenum dfactor)
+	{
+		if(sfactor == blendSrc && dfactor == blendDst)
+		{
+			savedStateChanges++;
+			return;
+		}
+
+		blendSrc = sfactor;
+		blendDst = dfactor;
+		stateChanges++;
+		glBlendFunc(sfactor, dfactor);
+	}
+
+	void bindTexture(GLuint texture)
+	{
+		if(texture == boundTexture)
+		{
+			savedStateChanges++;
+			return;
+		}
+
+		boundTexture = texture;
+		stateChanges++;
+		Profiler::count(Profiler::COUNTER_TEXTURE_BINDS);
+		glBindTexture(GL_TEXTURE_2D, texture);
+	}
+
+	void deleteTexture(GLuint texture)
+	{
+		//GL falls back to texture 0, and the name might be handed out again right away
+		if(texture == boundTexture)
+			boundTexture = 0;
+
+		glDeleteTextures(1, &texture);
+	}
+
+	void resetState()
+	{
+		for(int i = 0; i < capabilityCount; i++)
+		{
+			glDisable(trackedCapabilities[i]);
+			capabilityEnabled[i] = false;
+		}
+
+#ifndef USE_SHADERS
+		for(int i = 0; i < clientStateCount; i++)
+		{
+			glDisableClientState(trackedClientStates[i]);
+			clientStateEnabled[i] = false;
+		}
+#endif
+
+		blendSrc = GL_SRC_ALPHA;
+		blendDst = GL_ONE_MINUS_SRC_ALPHA;
+		glBlendFunc(blendSrc, blendDst);
+
+		boundTexture = 0;
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	void endStateFrame()
+	{
+		lastFrameStateChanges = stateChanges;
+		lastFrameSavedStateChanges = savedStateChanges;
+		stateChanges = 0;
+		savedStateChanges = 0;
+	}
+
+	unsigned int getStateChangeCount()
+	{
+		return lastFrameStateChanges;
+	}
+
+	unsigned int getSavedStateChangeCount()
+	{
+		return lastFrameSavedStateChanges;
+	}
+};
@@ -30,16 +30,50 @@ void Settings::setDefaults()
 	mBoolMap["PARSEGAMELISTONLY"] = false;
 	mBoolMap["IGNOREGAMELIST"] = false;
 	mBoolMap["DRAWFRAMERATE"] = false;
+	mBoolMap["DRAWMEMORY"] = false;
 	mBoolMap["DONTSHOWEXIT"] = false;
 	mBoolMap["DEBUG"] = false;
 	mBoolMap["WINDOWED"] = false;
 	mBoolMap["DISABLESOUNDS"] = false;
+	mBoolMap["SDFFONTS"] = false;
+	mBoolMap["VSYNC"] = true;
+	mBoolMap["PROFILE"] = false;
+	mBoolMap["PROFILESTARTUP"] = false;
+	mBoolMap["ThumbnailCache"] = true;
+	mBoolMap["Mipmaps"] = true;
 
 	mIntMap["DIMTIME"] = 30*1000;
+	mIntMap["MAXFPS"] = 60;
+	mIntMap["BENCHMARKFRAMES"] = 0;
+	mIntMap["FIXEDSTEP"] = 0;
     mIntMap["GameListSortIndex"] = 0;
+#ifdef _RPI_
+	mIntMap["TextureCacheSize"] = 24; //MB, the GPU usually only gets 64MB
+#else
+	mIntMap["TextureCacheSize"] = 128; //MB
+#endif
 
     mStringMap["RunOnGameSelect"] = "";
     mStringMap["RunOnFolderSelect"] = "";
+	mStringMap["TextureFormat"] = "rgba8888";
+	mStringMap["PROFILEFILE"] = "";
+	mStringMap["TRACEFILE"] = "";
+	mStringMap["RECORDINPUT"] = "";
+	mStringMap["REPLAYINPUT"] = "";
+}
+
+//these are set on the command line for a single run (benchmarks, profiling, input replays) and are never saved,
+//or saving the settings menu during such a run would make every later start do the same
+static const char* sessionOnlySettings[] = { "FIXEDSTEP", "RECORDINPUT", "REPLAYINPUT", "BENCHMARKFRAMES", "PROFILE", "PROFILEFILE", "TRACEFILE", "PROFILESTARTUP" };
+
+static bool isSessionOnly(const std::string& name)
+{
+	for(unsigned int i = 0; i < sizeof(sessionOnlySettings) / sizeof(sessionOnlySettings[0]); i++)
+	{
+		if(name == sessionOnlySettings[i])
+			return true;
+	}
+	return false;
 }
 
 template <typename K, typename V>
@@ -47,6 +81,9 @@ void saveMap(pugi::xml_document& doc, std::map<K, V>& map, const char* type)
 {
 	for(auto iter = map.begin(); iter != map.end(); iter++)
 	{
+		if(isSessionOnly(iter->first))
+			continue;
+
 		pugi::xml_node node = doc.append_child(type);
 		node.append_attribute("name").set_value(iter->first.c_str());
 		node.append_attribute("value").set_value(iter->second);
@@ -58,6 +95,9 @@ void saveMap(pugi::xml_document& doc, std::map<std::string, std::string>& map, c
 {
 	for(auto iter = map.begin(); iter != map.end(); iter++)
 	{
+		if(isSessionOnly(iter->first))
+			continue;
+
 		pugi::xml_node node = doc.append_child(type);
 		node.append_attribute("name").set_value(iter->first.c_str());
         node.append_attribute("value").set_value(iter->second.c_str());
@@ -93,14 +133,27 @@ void Settings::loadFile()
 		return;
 	}
 
+	//session only settings may still be in files saved by older versions
 	for(pugi::xml_node node = doc.child("bool"); node; node = node.next_sibling())
-		setBool(node.attribute("name").as_string(), node.attribute("value").as_bool());
+	{
+		if(!isSessionOnly(node.attribute("name").as_string()))
+			setBool(node.attribute("name").as_string(), node.attribute("value").as_bool());
+	}
 	for(pugi::xml_node node = doc.child("int"); node; node = node.next_sibling())
-		setInt(node.attribute("name").as_string(), node.attribute("value").as_int());
+	{
+		if(!isSessionOnly(node.attribute("name").as_string()))
+			setInt(node.attribute("name").as_string(), node.attribute("value").as_int());
+	}
 	for(pugi::xml_node node = doc.child("float"); node; node = node.next_sibling())
-		setFloat(node.attribute("name").as_string(), node.attribute("value").as_float());
+	{
+		if(!isSessionOnly(node.attribute("name").as_string()))
+			setFloat(node.attribute("name").as_string(), node.attribute("value").as_float());
+	}
     for(pugi::xml_node node = doc.child("string"); node; node = node.next_sibling())
-		setString(node.attribute("name").as_string(), node.attribute("value").as_string());
+	{
+		if(!isSessionOnly(node.attribute("name").as_string()))
+			setString(node.attribute("name").as_string(), node.attribute("value").as_string());
+	}
 }
 
 //Print a warning message if the setting we're trying to get doesn't already exist in the map, then return the value in the map.
@@ -2,6 +2,7 @@
 #include "AudioManager.h"
 #include "Log.h"
 #include "Settings.h"
+#include "MemoryStats.h"
 
 Sound::Sound(const std::string & path) : mSampleData(NULL), mSamplePos(0), mSampleLength(0), playing(false)
 {
@@ -57,6 +58,7 @@ void Sound::init()
 		mSampleFormat.freq = 44100;
 		mSampleFormat.format = AUDIO_S16;
 		SDL_UnlockAudio();
+		MemoryStats::add(MemoryStats::CATEGORY_SOUNDS, mSampleLength);
 	}
 	//free wav data now
     SDL_FreeWAV(data);
@@ -68,6 +70,7 @@ void Sound::deinit()
 
 	if(mSampleData != NULL)
 	{
+		MemoryStats::remove(MemoryStats::CATEGORY_SOUNDS, mSampleLength);
 		SDL_LockAudio();
 		delete[] mSampleData;
 		mSampleData = NULL;
@@ -0,0 +1,90 @@
+#include "StartupReport.h"
+#include "Log.h"
+#include "platform.h"
+#include <chrono>
+#include <iomanip>
+
+//initialized before main() runs, close enough to the start of the process
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+bool StartupReport::sFinished = false;
+std::vector<StartupReport::Phase> StartupReport::sPhases;
+std::vector<unsigned int> StartupReport::sOpenPhases;
+long long StartupReport::sTotalWallTime = 0;
+long long StartupReport::sTotalCpuTime = 0;
+size_t StartupReport::sPeakMemory = 0;
+
+long long StartupReport::now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void StartupReport::beginPhase(const std::string& name)
+{
+	if(sFinished)
+		return;
+
+	Phase phase;
+	phase.name = sOpenPhases.empty() ? name : sPhases.at(sOpenPhases.back()).name + "/" + name;
+	phase.depth = sOpenPhases.size();
+	phase.wallTime = 0;
+	phase.cpuTime = 0;
+	phase.cpuStart = getProcessCpuTime();
+	phase.wallStart = now();
+
+	sOpenPhases.push_back(sPhases.size());
+	sPhases.push_back(phase);
+}
+
+void StartupReport::endPhase()
+{
+	if(sFinished || sOpenPhases.empty())
+		return;
+
+	Phase& phase = sPhases.at(sOpenPhases.back());
+	phase.wallTime = now() - phase.wallStart;
+	phase.cpuTime = getProcessCpuTime() - phase.cpuStart;
+	sOpenPhases.pop_back();
+}
+
+void StartupReport::finish()
+{
+	if(sFinished)
+		return;
+
+	while(!sOpenPhases.empty())
+		endPhase();
+
+	sTotalWallTime = now();
+	sTotalCpuTime = getProcessCpuTime();
+	sPeakMemory = getPeakMemoryUsage();
+	sFinished = true;
+
+	LOG(LogInfo) << "Startup took " << std::fixed << std::setprecision(1) << sTotalWallTime / 1000.0f << "ms (" << sTotalCpuTime / 1000.0f
+		<< "ms CPU), peak memory use " << sPeakMemory / 1024 << "KB:";
+	for(unsigned int i = 0; i < sPhases.size(); i++)
+	{
+		const Phase& phase = sPhases.at(i);
+
+		//only the last part of the name, indented by depth
+		const size_t slash = phase.depth > 0 ? phase.name.find_last_of('/') : std::string::npos;
+		const std::string name = std::string(phase.depth * 2 + 2, ' ') + (slash != std::string::npos ? phase.name.substr(slash + 1) : phase.name);
+
+		LOG(LogInfo) << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(1)
+			<< " at " << std::setw(8) << phase.wallStart / 1000.0f << "ms: " << std::setw(8) << phase.wallTime / 1000.0f << "ms, "
+			<< std::setw(8) << phase.cpuTime / 1000.0f << "ms CPU";
+	}
+}
+
+void StartupReport::write(std::ostream& stream)
+{
+	stream << "phase\tstart_ms\twall_ms\tcpu_ms\n";
+	stream << std::fixed << std::setprecision(3);
+	for(unsigned int i = 0; i < sPhases.size(); i++)
+	{
+		const Phase& phase = sPhases.at(i);
+		stream << phase.name << "\t" << phase.wallStart / 1000.0 << "\t" << phase.wallTime / 1000.0 << "\t" << phase.cpuTime / 1000.0 << "\n";
+	}
+	stream << "total\t0.000\t" << sTotalWallTime / 1000.0 << "\t" << sTotalCpuTime / 1000.0 << "\n";
+	stream << "peak_memory_kb\t" << sPeakMemory / 1024 << "\n";
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+//Where the time from starting ES to its first frame goes. Phases (see StartupPhase) record their wall clock and CPU time,
+//and finish() logs them together with the peak memory use once the first frame is drawn. Times include nested phases.
+//Phases that begin after finish() aren't recorded, so code that also runs later on (Window::init after a game,
+//theme changes) can be a phase at the cost of a branch.
+//With --profile-startup ES also prints the report to stdout and quits after the first frame, for checking boot time budgets.
+class StartupReport
+{
+public:
+	static void beginPhase(const std::string& name);
+	static void endPhase();
+
+	//Ends startup and logs the report. Phases that are still open are ended first.
+	static void finish();
+	static inline bool isFinished() { return sFinished; }
+
+	//Tab separated, one line per phase: nested phases are named "parent/child", times are in ms since ES started.
+	static void write(std::ostream& stream);
+
+private:
+	struct Phase
+	{
+		std::string name; //including the names of the parent phases
+		unsigned int depth;
+		long long wallStart; //microseconds
+		long long wallTime;
+		long long cpuStart;
+		long long cpuTime;
+	};
+
+	static long long now(); //microseconds since ES started
+
+	static bool sFinished;
+	static std::vector<Phase> sPhases;
+	static std::vector<unsigned int> sOpenPhases; //indices into sPhases, innermost last
+	static long long sTotalWallTime;
+	static long long sTotalCpuTime;
+	static size_t sPeakMemory;
+};
+
+//Records the time between its construction and destruction as a startup phase called name (followed by detail, if given).
+class StartupPhase
+{
+public:
+	inline StartupPhase(const char* name, const std::string& detail = std::string()) : mActive(!StartupReport::isFinished())
+	{
+		if(mActive)
+			StartupReport::beginPhase(detail.empty() ? std::string(name) : std::string(name) + " " + detail);
+	}
+
+	inline ~StartupPhase()
+	{
+		if(mActive && !StartupReport::isFinished())
+			StartupReport::endPhase();
+	}
+
+private:
+	bool mActive;
+};
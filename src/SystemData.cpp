@@ -12,6 +12,8 @@
 #include "InputManager.h"
 #include <iostream>
 #include "Settings.h"
+#include "Trace.h"
+#include "StartupReport.h"
 
 std::vector<SystemData*> SystemData::sSystemVector;
 
@@ -37,14 +39,23 @@ SystemData::SystemData(std::string name, std::string descName, std::string start
 	mSearchExtension = extension;
 	mLaunchCommand = command;
 
+	StartupPhase phase("system", mName);
+
 	mRootFolder = new FolderData(this, mStartPath, "Search Root");
 
 	if(!Settings::getInstance()->getBool("PARSEGAMELISTONLY"))
+	{
+		StartupPhase scan("scan");
 		populateFolder(mRootFolder);
+	}
 
 	if(!Settings::getInstance()->getBool("IGNOREGAMELIST"))
+	{
+		StartupPhase parse("gamelist parse");
 		parseGamelist(this);
+	}
 
+	StartupPhase sort("sort");
 	mRootFolder->sort();
 }
 
@@ -144,6 +155,7 @@ void SystemData::launchGame(Window* window, GameData* game)
 void SystemData::populateFolder(FolderData* folder)
 {
 	std::string folderPath = folder->getPath();
+	TraceScope trace("SystemData::populateFolder", folderPath);
 	if(!fs::is_directory(folderPath))
 	{
 		LOG(LogWarning) << "Error - folder with path \"" << folderPath << "\" is not a directory!";
@@ -225,6 +237,7 @@ std::string SystemData::getDescName()
 //creates systems from information located in a config file
 bool SystemData::loadConfig(const std::string& path, bool writeExample)
 {
+	TraceScope trace("SystemData::loadConfig", path);
 	deleteSystems();
 
 	LOG(LogInfo) << "Loading system config file...";
@@ -0,0 +1,173 @@
+#include "Trace.h"
+#include "Log.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <map>
+#include <fstream>
+#include <cstring>
+#include <csignal>
+
+struct TraceEvent
+{
+	const char* name;
+	char detail[TRACE_DETAIL_LENGTH];
+	long long start;
+	long long duration;
+	std::thread::id thread;
+};
+
+//sequence is the number of the event in the slot + 1 once it's completely written, 0 while it's being written.
+//write() can run while other threads record (SIGUSR1), and skips slots that aren't complete
+struct TraceSlot
+{
+	std::atomic<unsigned int> sequence;
+	TraceEvent event;
+};
+
+//allocated by enable(), so ES doesn't carry the buffer around when tracing is off
+static std::unique_ptr<TraceSlot[]> slots;
+static std::atomic<unsigned int> nextEvent(0);
+
+static std::chrono::steady_clock::time_point startTime;
+static std::thread::id mainThread;
+
+static volatile sig_atomic_t writeRequested = 0;
+
+static void onSignal(int)
+{
+	//no file IO in a signal handler, the main loop picks this up in checkSignal()
+	writeRequested = 1;
+}
+
+static void writeEscaped(std::ofstream& file, const char* str)
+{
+	for(; *str != '\0'; str++)
+	{
+		const unsigned char c = *str;
+		if(c == '"' || c == '\\')
+			file << '\\' << c;
+		else if(c < 0x20)
+			file << ' ';
+		else
+			file << c;
+	}
+}
+
+bool Trace::sEnabled = false;
+std::string Trace::sPath;
+
+void Trace::enable(const std::string& path)
+{
+	sPath = path;
+	slots.reset(new TraceSlot[TRACE_BUFFER_SIZE]);
+	for(unsigned int i = 0; i < TRACE_BUFFER_SIZE; i++)
+		slots[i].sequence.store(0, std::memory_order_relaxed);
+	nextEvent = 0;
+	startTime = std::chrono::steady_clock::now();
+	mainThread = std::this_thread::get_id();
+	sEnabled = true;
+
+#ifndef WIN32
+	signal(SIGUSR1, &onSignal);
+#endif
+
+	LOG(LogInfo) << "Tracing to \"" << path << "\".";
+}
+
+long long Trace::now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Trace::record(const char* name, const char* detail, long long start, long long end)
+{
+	//slots are handed out atomically, so threads never write the same event (unless the buffer wraps around within one write)
+	const unsigned int index = nextEvent++;
+	TraceSlot& slot = slots[index % TRACE_BUFFER_SIZE];
+
+	slot.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	TraceEvent& event = slot.event;
+	event.name = name;
+	strncpy(event.detail, detail, TRACE_DETAIL_LENGTH - 1);
+	event.detail[TRACE_DETAIL_LENGTH - 1] = '\0';
+	event.start = start;
+	event.duration = end - start;
+	event.thread = std::this_thread::get_id();
+
+	slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+bool Trace::write()
+{
+	if(!sEnabled)
+		return false;
+
+	std::ofstream file(sPath.c_str());
+	if(!file.is_open())
+	{
+		LOG(LogError) << "Could not write trace to \"" << sPath << "\"!";
+		return false;
+	}
+
+	const unsigned int recorded = nextEvent;
+	const unsigned int count = recorded < TRACE_BUFFER_SIZE ? recorded : TRACE_BUFFER_SIZE;
+	const unsigned int first = recorded - count;
+
+	//chrome wants small numbers for threads. the main thread is 1, the others are numbered as they show up
+	std::map<std::thread::id, int> threads;
+	threads[mainThread] = 1;
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}";
+
+	unsigned int written = 0;
+	for(unsigned int i = first; i < recorded; i++)
+	{
+		//copy the event, and only use the copy if nobody started writing the slot before or during that
+		const TraceSlot& slot = slots[i % TRACE_BUFFER_SIZE];
+		if(slot.sequence.load(std::memory_order_acquire) != i + 1)
+			continue;
+		const TraceEvent event = slot.event;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(slot.sequence.load(std::memory_order_relaxed) != i + 1 || event.name == NULL)
+			continue;
+		written++;
+
+		auto thread = threads.find(event.thread);
+		if(thread == threads.end())
+		{
+			const int tid = threads.size() + 1;
+			thread = threads.insert(std::make_pair(event.thread, tid)).first;
+			file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":\"worker " << tid - 1 << "\"}}";
+		}
+
+		file << ",\n{\"name\":\"";
+		writeEscaped(file, event.name);
+		file << "\",\"cat\":\"es\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->second << ",\"ts\":" << event.start << ",\"dur\":" << event.duration;
+		if(event.detail[0] != '\0')
+		{
+			file << ",\"args\":{\"detail\":\"";
+			writeEscaped(file, event.detail);
+			file << "\"}";
+		}
+		file << "}";
+	}
+
+	file << "\n]}\n";
+
+	LOG(LogInfo) << "Wrote " << written << " trace events to \"" << sPath << "\"" << (recorded > count ? " (older events were overwritten)." : ".");
+	return true;
+}
+
+void Trace::checkSignal()
+{
+	if(writeRequested)
+	{
+		writeRequested = 0;
+		write();
+	}
+}
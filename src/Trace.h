@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+
+#define TRACE_BUFFER_SIZE 65536 //events kept in memory, the oldest are overwritten once it's full
+#define TRACE_DETAIL_LENGTH 96 //longer details (paths) are cut off
+
+//Timeline of what ES spends its time on, enabled with --trace. Disabled, a TraceScope costs one branch.
+//Scopes are recorded with their start time, duration and thread into a fixed ring buffer, and written as a Chrome trace
+//(chrome://tracing or ui.perfetto.dev) on exit. On POSIX systems SIGUSR1 writes the trace of a running ES as well.
+//Events can be recorded from any thread.
+class Trace
+{
+public:
+	//Starts recording. The trace is written to path by write().
+	static void enable(const std::string& path);
+	static inline bool isEnabled() { return sEnabled; }
+
+	static long long now(); //microseconds since enable()
+	static void record(const char* name, const char* detail, long long start, long long end);
+
+	//Writes everything in the buffer to the path given to enable().
+	static bool write();
+
+	//Call regularly from the main thread, writes the trace if a signal asked for it.
+	static void checkSignal();
+
+private:
+	static bool sEnabled;
+	static std::string sPath;
+};
+
+//Records the time between its construction and destruction as an event called name (a string literal).
+//detail is shown as an argument of the event, e.g. the path of the folder being scanned.
+class TraceScope
+{
+public:
+	inline TraceScope(const char* name, const std::string& detail = std::string()) : mName(NULL)
+	{
+		if(Trace::isEnabled())
+		{
+			mName = name;
+			mDetail = detail;
+			mStart = Trace::now();
+		}
+	}
+
+	inline ~TraceScope()
+	{
+		if(mName != NULL)
+			Trace::record(mName, mDetail.c_str(), mStart, Trace::now());
+	}
+
+private:
+	const char* mName;
+	std::string mDetail;
+	long long mStart;
+};
@@ -5,10 +5,17 @@
 #include "VolumeControl.h"
 #include "Log.h"
 #include "Settings.h"
+#include "resources/TextureLoader.h"
+#include "resources/TextureResource.h"
+#include "resources/TexturePool.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "StartupReport.h"
+#include "MemoryStats.h"
 #include <iomanip>
 
-Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCountElapsed(0), mAverageDeltaTime(10), 
-	mZoomFactor(1.0f), mCenterPoint(0, 0), mMatrix(Eigen::Affine3f::Identity()), mFadePercent(0.0f)
+Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCountElapsed(0), mRenderCountElapsed(0), mAverageDeltaTime(10), 
+	mDirty(true), mFramePending(false), mZoomFactor(1.0f), mCenterPoint(0, 0), mMatrix(Eigen::Affine3f::Identity()), mFadePercent(0.0f)
 {
 	mInputManager = new InputManager(this);
 	setCenterPoint(Eigen::Vector2f(Renderer::getScreenWidth() / 2, Renderer::getScreenHeight() / 2));
@@ -26,6 +33,7 @@ Window::~Window()
 void Window::pushGui(GuiComponent* gui)
 {
 	mGuiStack.push_back(gui);
+	invalidate();
 }
 
 void Window::removeGui(GuiComponent* gui)
@@ -35,6 +43,7 @@ void Window::removeGui(GuiComponent* gui)
 		if(*i == gui)
 		{
 			mGuiStack.erase(i);
+			invalidate();
 			return;
 		}
 	}
@@ -50,14 +59,22 @@ GuiComponent* Window::peekGui()
 
 bool Window::init(unsigned int width, unsigned int height)
 {
-	if(!Renderer::init(width, height))
+	TraceScope trace("Window::init");
 	{
-		LOG(LogError) << "Renderer failed to initialize!";
-		return false;
+		StartupPhase phase("renderer init");
+		if(!Renderer::init(width, height))
+		{
+			LOG(LogError) << "Renderer failed to initialize!";
+			return false;
+		}
 	}
 
-	mInputManager->init();
+	{
+		StartupPhase phase("input init");
+		mInputManager->init();
+	}
 
+	StartupPhase phase("font init");
 	mResourceManager.reloadAll();
 
 	//keep a reference to the default fonts, so they don't keep getting destroyed/recreated
@@ -68,6 +85,9 @@ bool Window::init(unsigned int width, unsigned int height)
 		mDefaultFonts.push_back(Font::get(mResourceManager, Font::getDefaultPath(), FONT_SIZE_LARGE));
 	}
 
+	//the screen is blank after (re)initializing, so everything has to be drawn again
+	invalidate();
+
 	return true;
 }
 
@@ -75,6 +95,7 @@ void Window::deinit()
 {
 	mInputManager->deinit();
 	mResourceManager.unloadAll();
+	TexturePool::getInstance()->clear();
 	Renderer::deinit();
 }
 
@@ -90,6 +111,10 @@ void Window::input(InputConfig* config, Input input)
 	}
 	else if(peekGui())
 		this->peekGui()->input(config, input);
+
+	//input almost always changes what's on screen (selection, menus, ...), so just redraw instead of
+	//making every GUI track its own state
+	invalidate();
 }
 
 void Window::update(int deltaTime)
@@ -110,27 +135,56 @@ void Window::update(int deltaTime)
 		if(Settings::getInstance()->getBool("DRAWFRAMERATE"))
 		{
 			std::stringstream ss;
-			ss << std::fixed << std::setprecision(1) << (1000.0f * (float)mFrameCountElapsed / (float)mFrameTimeElapsed) << "fps, ";
-			ss << std::fixed << std::setprecision(2) << ((float)mFrameTimeElapsed / (float)mFrameCountElapsed) << "ms";
+			ss << std::fixed << std::setprecision(1) << (1000.0f * (float)mRenderCountElapsed / (float)mFrameTimeElapsed) << "fps, ";
+			ss << std::fixed << std::setprecision(2) << ((float)mFrameTimeElapsed / (float)mFrameCountElapsed) << "ms, ";
+			ss << Renderer::getStateChangeCount() << " GL state changes (" << Renderer::getSavedStateChangeCount() << " skipped)";
 			mFrameDataString = ss.str();
+			invalidate();
+		}
+
+		if(Settings::getInstance()->getBool("DRAWMEMORY"))
+		{
+			mMemoryString = MemoryStats::getSummary();
+			invalidate();
 		}
 
 		mFrameTimeElapsed = 0;
 		mFrameCountElapsed = 0;
+		mRenderCountElapsed = 0;
 	}
 
+	//hand images decoded in the background to GL, images that finish here are picked up by the update below
+	TextureLoader::getInstance()->processUploads();
+
+	if(Profiler::hasNewOverlay())
+		invalidate();
+
 	if(peekGui())
+	{
+		TraceScope trace("Window::update");
+		ProfileScope scope(peekGui(), Profiler::PHASE_UPDATE);
 		peekGui()->update(deltaTime);
+	}
 }
 
 void Window::render()
 {
+	TraceScope trace("Window::render");
+
 	//there's nothing to render, which should pretty much never happen
 	if(mGuiStack.size() == 0)
 		std::cout << "guistack empty\n";
 
+	//clear the flag before drawing, so changes made while rendering still cause another frame.
+	//the main loop swaps before it renders, so a dirty frame only reaches the screen with the next swap.
+	//draw it once more so that swap happens (this also keeps the back buffer current for ImageComponent::copyScreen()).
+	mFramePending = mDirty;
+	mDirty = false;
+	mRenderCountElapsed++;
+
 	for(unsigned int i = 0; i < mGuiStack.size(); i++)
 	{
+		ProfileScope scope(mGuiStack.at(i), Profiler::PHASE_RENDER);
 		mGuiStack.at(i)->render(mMatrix);
 	}
 
@@ -141,6 +195,46 @@ void Window::render()
 		Renderer::setMatrix(Eigen::Affine3f::Identity());
 		mDefaultFonts.at(1)->drawText(mFrameDataString, Eigen::Vector2f(50, 50), 0xFF00FFFF);
 	}
+
+	if(Settings::getInstance()->getBool("DRAWMEMORY"))
+	{
+		//below the framerate
+		Renderer::setMatrix(Eigen::Affine3f::Identity());
+		mDefaultFonts.at(1)->drawText(mMemoryString, Eigen::Vector2f(50, 50.0f + mDefaultFonts.at(1)->getHeight()), 0xFF00FFFF);
+	}
+
+	if(Profiler::isEnabled())
+		Profiler::drawOverlay(*mDefaultFonts.at(0));
+
+	Renderer::flushQuads();
+}
+
+bool Window::renderToTexture(TextureResource& target)
+{
+	if(!target.initAsRenderTarget(Renderer::getScreenWidth(), Renderer::getScreenHeight()))
+		return false;
+
+	Renderer::bindRenderTarget(target.getFramebufferID());
+
+	for(unsigned int i = 0; i < mGuiStack.size(); i++)
+	{
+		mGuiStack.at(i)->render(mMatrix);
+	}
+
+	postProcess();
+
+	Renderer::bindRenderTarget(0);
+	return true;
+}
+
+void Window::invalidate()
+{
+	mDirty = true;
+}
+
+bool Window::isDirty() const
+{
+	return mDirty || mFramePending;
 }
 
 void Window::normalizeNextUpdate()
@@ -160,12 +254,18 @@ ResourceManager* Window::getResourceManager()
 
 void Window::setZoomFactor(const float& zoom)
 {
+	if(mZoomFactor != zoom)
+		invalidate();
+
 	mZoomFactor = zoom;
 	updateMatrix();
 }
 
 void Window::setCenterPoint(const Eigen::Vector2f& point)
 {
+	if(mCenterPoint != point)
+		invalidate();
+
 	mCenterPoint = point;
 	updateMatrix();
 }
@@ -182,6 +282,9 @@ void Window::updateMatrix()
 
 void Window::setFadePercent(const float& perc)
 {
+	if(mFadePercent != perc)
+		invalidate();
+
 	mFadePercent = perc;
 }
 
@@ -7,6 +7,8 @@
 #include <vector>
 #include "Font.h"
 
+class TextureResource;
+
 class Window
 {
 public:
@@ -21,6 +23,16 @@ public:
 	void update(int deltaTime);
 	void render();
 
+	//Retained rendering: nothing is drawn unless something changed since the last frame.
+	//invalidate() flags the screen as changed (components go through GuiComponent::markDirty()).
+	//isDirty() tells the main loop whether render() (and the buffer swap) are necessary.
+	void invalidate();
+	bool isDirty() const;
+
+	//Draws what render() would draw into target instead of the screen (without the framerate display).
+	//Returns false if render targets aren't supported, see TextureResource::initAsRenderTarget().
+	bool renderToTexture(TextureResource& target);
+
 	bool init(unsigned int width = 0, unsigned int height = 0);
 	void deinit();
 
@@ -43,11 +55,16 @@ private:
 
 	int mFrameTimeElapsed;
 	int mFrameCountElapsed;
+	int mRenderCountElapsed;
 	int mAverageDeltaTime;
 	std::string mFrameDataString;
+	std::string mMemoryString;
 
 	bool mNormalizeNextUpdate;
 
+	bool mDirty;
+	bool mFramePending; //last frame was drawn but not swapped to the screen yet
+
 	float mZoomFactor;
 	Eigen::Vector2f mCenterPoint;
 
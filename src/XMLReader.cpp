@@ -4,6 +4,7 @@
 #include "pugiXML/pugixml.hpp"
 #include <boost/filesystem.hpp>
 #include "Log.h"
+#include "Trace.h"
 
 //this is obviously an incredibly inefficient way to go about searching
 //but I don't think it'll matter too much with the size of most collections
@@ -101,6 +102,7 @@ GameData* createGameFromPath(std::string gameAbsPath, SystemData* system)
 
 void parseGamelist(SystemData* system)
 {
+	TraceScope trace("parseGamelist", system->getName());
 	std::string xmlpath = system->getGamelistPath();
 
 	if(xmlpath.empty())
@@ -261,6 +263,7 @@ void addGameDataNode(pugi::xml_node & parent, const GameData * game)
 
 void updateGamelist(SystemData* system)
 {
+	TraceScope trace("updateGamelist", system->getName());
 	//We do this by reading the XML again, adding changes and then writing it back,
 	//because there might be information missing in our systemdata which would then miss in the new XML.
 	//We have the complete information for every game though, so we can simply remove a game
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+
+//Tiny timing harness for es_bench. A benchmark runs its function until minTime has passed (after one warmup call)
+//and prints the average time per call, plus throughput if it knows how many bytes one call processes.
+//Every result is also kept, so main() can write them all to a JSON file for tracking over time.
+namespace Benchmark
+{
+	struct Options
+	{
+		std::string filter; //only run benchmarks whose name contains this
+		int minTimeMs;
+	};
+
+	struct Result
+	{
+		std::string name;
+		double perCallUs;
+		unsigned int calls;
+		size_t bytesPerCall;
+	};
+
+	inline std::vector<Result>& getResults()
+	{
+		static std::vector<Result> results;
+		return results;
+	}
+
+	inline bool shouldRun(const Options& options, const std::string& name)
+	{
+		return options.filter.empty() || name.find(options.filter) != std::string::npos;
+	}
+
+	//Returns the average time per call in microseconds.
+	inline double run(const Options& options, const std::string& name, const std::function<void()>& func, size_t bytesPerCall = 0)
+	{
+		if(!shouldRun(options, name))
+			return 0;
+
+		typedef std::chrono::high_resolution_clock Clock;
+
+		func(); //warm up caches and allocators
+
+		unsigned int calls = 0;
+		const Clock::time_point start = Clock::now();
+		Clock::time_point now = start;
+		while(std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count() < options.minTimeMs || calls == 0)
+		{
+			func();
+			calls++;
+			now = Clock::now();
+		}
+
+		const double totalUs = (double)std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+		const double perCallUs = totalUs / calls;
+
+		std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(12) << perCallUs << " us";
+		if(bytesPerCall != 0 && perCallUs > 0)
+			std::cout << std::setw(12) << (bytesPerCall / perCallUs) << " MB/s";
+		std::cout << "  (" << calls << " calls)\n";
+
+		Result result;
+		result.name = name;
+		result.perCallUs = perCallUs;
+		result.calls = calls;
+		result.bytesPerCall = bytesPerCall;
+		getResults().push_back(result);
+
+		return perCallUs;
+	}
+
+	extern const void* volatile doNotOptimizeSink; //defined in main.cpp
+
+	//Keeps the compiler from optimizing away results.
+	inline void doNotOptimize(const void* p)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		//tells the compiler p (and whatever it points to) is used, without generating any code
+		asm volatile("" : : "g"(p) : "memory");
+#else
+		doNotOptimizeSink = p;
+#endif
+	}
+}
+
+//benchmark groups, see the *Bench.cpp files
+void runImageIOBenchmarks(const Benchmark::Options& options);
+void runGameListBenchmarks(const Benchmark::Options& options);
+void runFontBenchmarks(const Benchmark::Options& options);
+void runRenderBenchmarks(const Benchmark::Options& options);
@@ -0,0 +1,79 @@
+#include "Benchmark.h"
+#include "../Font.h"
+#include "../Renderer.h"
+#include "../Settings.h"
+#include "../resources/ResourceManager.h"
+#include <sstream>
+
+//about as long as a game's description in a gamelist, wrapped in the detailed view
+static const std::string description = "In a distant future the last colony ship drifts between the stars. Its crew has been asleep for "
+	"three hundred years, until the ship's computer wakes a single engineer to repair a failing reactor. Explore twelve decks "
+	"of derelict corridors, solve puzzles with the tools you find along the way and uncover what happened to the rest of the crew. "
+	"Features a branching story with four endings, a dynamic soundtrack and over forty hours of gameplay.";
+
+void runFontBenchmarks(const Benchmark::Options& options)
+{
+	//everything here needs a GL context, don't open a window if nothing would use it
+	if(!Benchmark::shouldRun(options, "Font/buildAtlas/") && !Benchmark::shouldRun(options, "Font/buildTextCache")
+		&& !Benchmark::shouldRun(options, "Font/sizeText") && !Benchmark::shouldRun(options, "Font/sizeWrappedText"))
+		return;
+
+	Settings::getInstance()->setBool("WINDOWED", true);
+	if(!Renderer::init(640, 480))
+	{
+		std::cout << "Font: could not create a GL context, skipping font benchmarks.\n";
+		return;
+	}
+
+	const std::string path = Font::getDefaultPath();
+	if(path.empty())
+	{
+		std::cout << "Font: no default font found, skipping font benchmarks.\n";
+		Renderer::deinit();
+		return;
+	}
+
+	ResourceManager rm;
+
+	const unsigned int sizes[] = { FONT_SIZE_SMALL, FONT_SIZE_MEDIUM, FONT_SIZE_LARGE };
+	for(unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		std::stringstream name;
+		name << "Font/buildAtlas/" << sizes[s];
+
+		//reload() rasterizes all glyphs and uploads the atlas
+		std::shared_ptr<Font> font = Font::get(rm, path, sizes[s]);
+		Benchmark::run(options, name.str(), [&] {
+			font->unload(rm);
+			font->reload(rm);
+		});
+	}
+
+	std::shared_ptr<Font> font = Font::get(rm, path, FONT_SIZE_MEDIUM);
+	const std::string title = "The Legend of the Mystical Ninja: Quest for the Golden Dragon";
+
+	Benchmark::run(options, "Font/buildTextCache/title", [&] {
+		TextCache* cache = font->buildTextCache(title, 0, 0, 0xFFFFFFFF);
+		Benchmark::doNotOptimize(cache);
+		delete cache;
+	});
+
+	Benchmark::run(options, "Font/buildTextCache/description", [&] {
+		TextCache* cache = font->buildTextCache(description, 0, 0, 0xFFFFFFFF);
+		Benchmark::doNotOptimize(cache);
+		delete cache;
+	});
+
+	Benchmark::run(options, "Font/sizeText", [&] {
+		Eigen::Vector2f size = font->sizeText(title);
+		Benchmark::doNotOptimize(&size);
+	});
+
+	Benchmark::run(options, "Font/sizeWrappedText", [&] {
+		Eigen::Vector2f size = font->sizeWrappedText(description, 400);
+		Benchmark::doNotOptimize(&size);
+	});
+
+	font.reset();
+	Renderer::deinit();
+}
@@ -0,0 +1,186 @@
+#include "Benchmark.h"
+#include "../SystemData.h"
+#include "../FolderData.h"
+#include "../XMLReader.h"
+#include "../Settings.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+namespace fs = boost::filesystem;
+
+//parseGamelist() and updateGamelist() look up every game with a linear search, so they're only run on trees up to this size
+#define GAMELIST_QUADRATIC_MAX_GAMES 10000
+
+struct SyntheticTree
+{
+	const char* name;
+	unsigned int games;
+	unsigned int depth; //folders between the system's root and the games
+	unsigned int gamesPerFolder;
+};
+
+static const SyntheticTree trees[] = {
+	{ "1k", 1000, 1, 100 },
+	{ "10k", 10000, 2, 100 },
+	{ "10k-deep", 10000, 8, 4 },
+	{ "100k", 100000, 3, 100 }
+};
+
+static const char* titleWords[] = { "Super", "Mega", "Final", "Dragon", "Quest", "Fighter", "Kart", "Racer",
+	"Legend", "Shadow", "Star", "Metal", "Soccer", "Puzzle", "Island", "Castle" };
+static const unsigned int titleWordCount = sizeof(titleWords) / sizeof(titleWords[0]);
+
+//fixed seed, so every run and every machine gets the same tree
+static unsigned int nextRandom(unsigned int& state)
+{
+	state = state * 1103515245 + 12345;
+	return (state >> 16) & 0x7FFF;
+}
+
+//Creates a system folder with tree.games empty .rom files spread over tree.depth levels of folders,
+//and a gamelist.xml with metadata for all of them. Returns the folder.
+static std::string createTree(const SyntheticTree& tree)
+{
+	const fs::path root = fs::temp_directory_path() / fs::unique_path(std::string("es_bench_") + tree.name + "_%%%%%%");
+	fs::create_directories(root);
+
+	//enough folders per level that the leaves can hold all games
+	const unsigned int leaves = (tree.games + tree.gamesPerFolder - 1) / tree.gamesPerFolder;
+	unsigned int branch = (unsigned int)ceil(pow((double)leaves, 1.0 / tree.depth));
+	if(branch < 2)
+		branch = 2;
+
+	std::ofstream gamelist((root / "gamelist.xml").string().c_str());
+	gamelist << "<?xml version=\"1.0\"?>\n<gameList>\n";
+
+	unsigned int random = 1;
+	fs::path folder;
+	for(unsigned int i = 0; i < tree.games; i++)
+	{
+		if(i % tree.gamesPerFolder == 0)
+		{
+			//the leaf's number, one digit per level
+			const unsigned int leaf = i / tree.gamesPerFolder;
+			folder = root;
+			unsigned int divisor = 1;
+			for(unsigned int level = 1; level < tree.depth; level++)
+				divisor *= branch;
+			for(unsigned int level = 0; level < tree.depth; level++)
+			{
+				std::stringstream name;
+				name << "folder" << (leaf / divisor) % branch;
+				folder /= name.str();
+				divisor /= branch;
+			}
+			fs::create_directories(folder);
+		}
+
+		std::stringstream title;
+		title << titleWords[nextRandom(random) % titleWordCount] << " " << titleWords[nextRandom(random) % titleWordCount] << " " << i;
+
+		const fs::path game = folder / (title.str() + ".rom");
+		std::ofstream(game.string().c_str());
+
+		gamelist << "\t<game>\n";
+		gamelist << "\t\t<path>" << game.generic_string() << "</path>\n";
+		gamelist << "\t\t<name>" << title.str() << "</name>\n";
+		gamelist << "\t\t<desc>" << title.str() << " is a synthetic game, generated to see how fast EmulationStation reads and sorts game lists. "
+			"Its description is about as long as a real one.</desc>\n";
+		gamelist << "\t\t<rating>" << (nextRandom(random) % 100) / 100.0f << "</rating>\n";
+		gamelist << "\t\t<userrating>" << (nextRandom(random) % 100) / 100.0f << "</userrating>\n";
+		gamelist << "\t\t<timesplayed>" << nextRandom(random) % 50 << "</timesplayed>\n";
+		gamelist << "\t\t<lastplayed>" << 1300000000 + nextRandom(random) * 1000 << "</lastplayed>\n";
+		gamelist << "\t</game>\n";
+	}
+
+	gamelist << "</gameList>\n";
+	return root.string();
+}
+
+static SystemData* createSystem(const std::string& root, bool scan, bool parse)
+{
+	Settings::getInstance()->setBool("PARSEGAMELISTONLY", !scan);
+	Settings::getInstance()->setBool("IGNOREGAMELIST", !parse);
+	return new SystemData("bench", "Benchmark", root, ".rom", "");
+}
+
+static void deleteSystem(SystemData* system)
+{
+	//the destructor would write the gamelist back
+	Settings::getInstance()->setBool("IGNOREGAMELIST", true);
+	delete system;
+}
+
+void runGameListBenchmarks(const Benchmark::Options& options)
+{
+	struct SortMode
+	{
+		const char* name;
+		FolderData::ComparisonFunction& function;
+	};
+	const SortMode sortModes[] = {
+		{ "filename", FolderData::compareFileName },
+		{ "rating", FolderData::compareRating },
+		{ "userrating", FolderData::compareUserRating },
+		{ "timesplayed", FolderData::compareTimesPlayed },
+		{ "lastplayed", FolderData::compareLastPlayed }
+	};
+
+	for(unsigned int t = 0; t < sizeof(trees) / sizeof(trees[0]); t++)
+	{
+		const SyntheticTree& tree = trees[t];
+		const std::string prefix = std::string("GameList/") + tree.name + "/";
+
+		//creating 100k files takes a while, don't if nothing would use them
+		bool used = false;
+		const char* names[] = { "populateFolder", "parseGamelist", "updateGamelist" };
+		for(unsigned int n = 0; n < sizeof(names) / sizeof(names[0]); n++)
+			used = used || Benchmark::shouldRun(options, prefix + names[n]);
+		for(unsigned int m = 0; m < sizeof(sortModes) / sizeof(sortModes[0]); m++)
+			used = used || Benchmark::shouldRun(options, prefix + "FolderData::sort/" + sortModes[m].name);
+		if(!used)
+			continue;
+
+		const std::string root = createTree(tree);
+		const bool quadratic = tree.games <= GAMELIST_QUADRATIC_MAX_GAMES;
+
+		//includes the name sort the constructor does, it's a small part of the scan
+		Benchmark::run(options, prefix + "populateFolder", [&] {
+			deleteSystem(createSystem(root, true, false));
+		});
+
+		if(quadratic)
+		{
+			Benchmark::run(options, prefix + "parseGamelist", [&] {
+				SystemData* system = createSystem(root, false, false);
+				parseGamelist(system);
+				deleteSystem(system);
+			});
+		}
+
+		//a complete system for the rest, like after startup
+		SystemData* system = createSystem(root, true, true);
+
+		if(quadratic)
+		{
+			Benchmark::run(options, prefix + "updateGamelist", [&] {
+				updateGamelist(system);
+			});
+		}
+
+		for(unsigned int m = 0; m < sizeof(sortModes) / sizeof(sortModes[0]); m++)
+		{
+			//alternate the direction, so every call sorts the reverse of the last result instead of already sorted data
+			bool ascending = true;
+			Benchmark::run(options, prefix + "FolderData::sort/" + sortModes[m].name, [&] {
+				system->getRootFolder()->sort(sortModes[m].function, ascending);
+				ascending = !ascending;
+			});
+		}
+
+		deleteSystem(system);
+		fs::remove_all(root);
+	}
+}
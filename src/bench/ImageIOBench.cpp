@@ -0,0 +1,149 @@
+#include "Benchmark.h"
+#include "../ImageIO.h"
+#include <memory.h>
+#include <sstream>
+
+//the conversion ImageIO::loadFromMemoryRGBA32 used to do: copy the scanlines into a temporary buffer,
+//swap the channels one RGBQUAD at a time, then copy everything into the result
+static std::vector<unsigned char> convertReference(const std::vector<unsigned char>& image, size_t width, size_t height)
+{
+	unsigned char * tempData = new unsigned char[width * height * 4];
+	for (size_t i = 0; i < height; i++)
+		memcpy(tempData + (i * width * 4), image.data() + (i * width * 4), width * 4);
+
+	for(size_t i = 0; i < width*height; i++)
+	{
+		RGBQUAD bgra = ((RGBQUAD *)tempData)[i];
+		RGBQUAD rgba;
+		rgba.rgbBlue = bgra.rgbRed;
+		rgba.rgbGreen = bgra.rgbGreen;
+		rgba.rgbRed = bgra.rgbBlue;
+		rgba.rgbReserved = bgra.rgbReserved;
+		((RGBQUAD *)tempData)[i] = rgba;
+	}
+
+	std::vector<unsigned char> rawData(tempData, tempData + width * height * 4);
+	delete[] tempData;
+	return rawData;
+}
+
+//what it does now: one pass per scanline, straight into the result
+static std::vector<unsigned char> convertOptimized(const std::vector<unsigned char>& image, size_t width, size_t height)
+{
+	std::vector<unsigned char> rawData(width * height * 4);
+	for (size_t i = 0; i < height; i++)
+		ImageIO::convertBGRAToRGBA(image.data() + (i * width * 4), rawData.data() + (i * width * 4), width);
+	return rawData;
+}
+
+//Encodes a width x height test image as a PNG or JPEG in memory. The image is a gradient with some noise,
+//so it compresses about like a screenshot instead of collapsing into a few bytes.
+static std::vector<unsigned char> encodeImage(FREE_IMAGE_FORMAT format, size_t width, size_t height)
+{
+	FIBITMAP* bitmap = FreeImage_Allocate((int)width, (int)height, 24);
+	unsigned int random = 1;
+	for(size_t y = 0; y < height; y++)
+	{
+		BYTE* line = FreeImage_GetScanLine(bitmap, (int)y);
+		for(size_t x = 0; x < width; x++)
+		{
+			random = random * 1103515245 + 12345;
+			const unsigned char noise = (random >> 16) & 0x1F;
+			line[x * 3 + 0] = (unsigned char)(x * 255 / width) ^ noise;
+			line[x * 3 + 1] = (unsigned char)(y * 255 / height);
+			line[x * 3 + 2] = (unsigned char)((x + y) & 0xFF);
+		}
+	}
+
+	std::vector<unsigned char> result;
+	FIMEMORY* memory = FreeImage_OpenMemory();
+	if(FreeImage_SaveToMemory(format, bitmap, memory, 0))
+	{
+		BYTE* data = NULL;
+		DWORD size = 0;
+		FreeImage_AcquireMemory(memory, &data, &size);
+		result.assign(data, data + size);
+	}
+	FreeImage_CloseMemory(memory);
+	FreeImage_Unload(bitmap);
+	return result;
+}
+
+static void runDecodeBenchmarks(const Benchmark::Options& options, const size_t sizes[][2], unsigned int sizeCount)
+{
+	const struct { FREE_IMAGE_FORMAT format; const char* name; } formats[] = { { FIF_PNG, "png" }, { FIF_JPEG, "jpg" } };
+
+	for(unsigned int f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+	{
+		for(unsigned int s = 0; s < sizeCount; s++)
+		{
+			const size_t width = sizes[s][0];
+			const size_t height = sizes[s][1];
+
+			std::stringstream name;
+			name << "ImageIO/decode/" << formats[f].name << "/" << width << "x" << height;
+			if(!Benchmark::shouldRun(options, name.str()))
+				continue;
+
+			const std::vector<unsigned char> file = encodeImage(formats[f].format, width, height);
+			if(file.empty())
+			{
+				std::cout << "ImageIO: could not encode a " << formats[f].name << " test image!\n";
+				continue;
+			}
+
+			//a reused buffer, like TextureLoader's workers have
+			std::vector<unsigned char> pixels;
+			Benchmark::run(options, name.str(), [&] {
+				size_t w, h;
+				ImageIO::loadFromMemoryRGBA32(file.data(), file.size(), pixels, w, h);
+				Benchmark::doNotOptimize(pixels.data());
+			}, file.size());
+
+			//scaled down while decoding, like images with a max size
+			Benchmark::run(options, name.str() + "/thumbnail", [&] {
+				size_t w, h;
+				ImageIO::loadFromMemoryRGBA32(file.data(), file.size(), pixels, w, h, 256, 256);
+				Benchmark::doNotOptimize(pixels.data());
+			}, file.size());
+		}
+	}
+}
+
+void runImageIOBenchmarks(const Benchmark::Options& options)
+{
+	//typical screenshot sizes, from scaled down thumbnails to full HD captures
+	const size_t sizes[][2] = { {320, 240}, {640, 480}, {1280, 720}, {1920, 1080} };
+
+	for(unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		const size_t width = sizes[s][0];
+		const size_t height = sizes[s][1];
+
+		std::vector<unsigned char> image(width * height * 4);
+		for(size_t i = 0; i < image.size(); i++)
+			image[i] = (unsigned char)(i * 7 + i / 13);
+
+		//make sure both produce the same pixels before timing anything
+		if(convertReference(image, width, height) != convertOptimized(image, width, height))
+		{
+			std::cout << "ImageIO: conversion results differ at " << width << "x" << height << "!\n";
+			continue;
+		}
+
+		std::stringstream name;
+		name << "ImageIO/BGRAToRGBA/" << width << "x" << height;
+
+		Benchmark::run(options, name.str() + "/reference", [&] {
+			std::vector<unsigned char> result = convertReference(image, width, height);
+			Benchmark::doNotOptimize(result.data());
+		}, image.size());
+
+		Benchmark::run(options, name.str() + "/optimized", [&] {
+			std::vector<unsigned char> result = convertOptimized(image, width, height);
+			Benchmark::doNotOptimize(result.data());
+		}, image.size());
+	}
+
+	runDecodeBenchmarks(options, sizes, sizeof(sizes) / sizeof(sizes[0]));
+}
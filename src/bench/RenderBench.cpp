@@ -0,0 +1,84 @@
+#include "Benchmark.h"
+#include "../Renderer.h"
+#include "../Settings.h"
+#include "../Window.h"
+#include "../Font.h"
+#include "../components/TextListComponent.h"
+#include "../components/GuiSettingsMenu.h"
+#include <sstream>
+
+//Times how long a component takes to generate its render commands, without drawing anything (see Renderer::beginRecording()),
+//and how long executing them takes.
+static void runScene(const Benchmark::Options& options, const std::string& name, GuiComponent& component)
+{
+	Renderer::CommandList commands;
+
+	Benchmark::run(options, "Render/record/" + name, [&] {
+		commands.clear();
+		Renderer::beginRecording(&commands, false);
+		component.render(Eigen::Affine3f::Identity());
+		Renderer::endRecording();
+	});
+
+	if(Benchmark::shouldRun(options, "Render/record/" + name))
+	{
+		std::cout << "  " << commands.commands.size() << " commands: " << commands.getCount(Renderer::COMMAND_QUAD) << " quads, "
+			<< commands.getCount(Renderer::COMMAND_RECT) << " rects, " << commands.getCount(Renderer::COMMAND_TEXT) << " text runs, "
+			<< commands.getCount(Renderer::COMMAND_SET_MATRIX) << " matrices, "
+			<< commands.getCount(Renderer::COMMAND_PUSH_CLIP) + commands.getCount(Renderer::COMMAND_POP_CLIP) << " clip changes\n";
+	}
+
+	if(!Benchmark::shouldRun(options, "Render/execute/" + name))
+		return;
+
+	commands.clear();
+	Renderer::beginRecording(&commands, false);
+	component.render(Eigen::Affine3f::Identity());
+	Renderer::endRecording();
+
+	//glFinish, so what's timed includes the GL actually drawing it
+	Benchmark::run(options, "Render/execute/" + name, [&] {
+		Renderer::executeCommands(commands);
+		glFinish();
+	});
+}
+
+void runRenderBenchmarks(const Benchmark::Options& options)
+{
+	//opening a window takes a while, don't if nothing would use it
+	const char* names[] = { "Render/record/gamelist", "Render/execute/gamelist", "Render/record/settings", "Render/execute/settings" };
+	bool used = false;
+	for(unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+		used = used || Benchmark::shouldRun(options, names[i]);
+	if(!used)
+		return;
+
+	//fonts and textures still need a GL context, even if nothing is drawn
+	Settings::getInstance()->setBool("WINDOWED", true);
+	Window window;
+	if(!window.init(640, 480))
+	{
+		std::cout << "Render: could not create a GL context, skipping render benchmarks.\n";
+		return;
+	}
+
+	{
+		//a long game list, only the visible rows are drawn
+		TextListComponent<int> list(&window, 0, 0, Font::get(*window.getResourceManager(), Font::getDefaultPath(), FONT_SIZE_MEDIUM));
+		for(int i = 0; i < 1000; i++)
+		{
+			std::stringstream name;
+			name << "Game number " << i;
+			list.addObject(name.str(), i, 0x0000FFFF);
+		}
+		list.setSelection(500);
+		runScene(options, "gamelist", list);
+	}
+
+	{
+		GuiSettingsMenu menu(&window);
+		runScene(options, "settings", menu);
+	}
+
+	window.deinit();
+}
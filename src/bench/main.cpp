@@ -0,0 +1,75 @@
+//es_bench - microbenchmarks for EmulationStation's hot paths.
+//Usage: es_bench [filter] [--min-time ms] [--json path]
+//Only benchmarks whose name contains filter are run. --json writes all results to path, for tracking them over time.
+
+#include "Benchmark.h"
+#include "../Log.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+const void* volatile Benchmark::doNotOptimizeSink = NULL;
+
+static bool writeJson(const std::string& path)
+{
+	std::ofstream file(path.c_str());
+	if(!file.is_open())
+	{
+		std::cout << "Could not write results to \"" << path << "\"!\n";
+		return false;
+	}
+
+	const std::vector<Benchmark::Result>& results = Benchmark::getResults();
+
+	//benchmark names never contain characters that would need escaping
+	file << "[\n";
+	for(unsigned int i = 0; i < results.size(); i++)
+	{
+		const Benchmark::Result& result = results.at(i);
+		file << "  {\"name\": \"" << result.name << "\", \"us_per_call\": " << std::fixed << std::setprecision(3) << result.perCallUs
+			<< ", \"calls\": " << result.calls << ", \"bytes_per_call\": " << result.bytesPerCall << "}";
+		file << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	file << "]\n";
+
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	Benchmark::Options options;
+	options.minTimeMs = 500;
+	std::string jsonPath;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+		{
+			options.minTimeMs = atoi(argv[i + 1]);
+			i++;
+		}else if(strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+		{
+			jsonPath = argv[i + 1];
+			i++;
+		}else if(strcmp(argv[i], "--help") == 0)
+		{
+			std::cout << "usage: es_bench [filter] [--min-time ms] [--json path]\n";
+			return 0;
+		}else{
+			options.filter = argv[i];
+		}
+	}
+
+	//the code under test logs a lot, and there's no log file
+	Log::setReportingLevel(LogError);
+
+	runImageIOBenchmarks(options);
+	runGameListBenchmarks(options);
+	runFontBenchmarks(options);
+	runRenderBenchmarks(options);
+
+	if(!jsonPath.empty() && !writeJson(jsonPath))
+		return 1;
+
+	return 0;
+}
@@ -69,47 +69,33 @@ void GuiBox::render(const Eigen::Affine3f& parentTrans)
 
 	mBackgroundImage.render(trans);
 
+	//the border images are drawn several times, mirrored where needed. these are queued as quads, so all pieces
+	//that share a texture end up in a single draw call.
+
 	//left border
-	mVerticalImage.setPosition(-getVerticalBorderWidth(), 0);
-	mVerticalImage.setFlipX(false);
-	mVerticalImage.render(trans);
+	mVerticalImage.renderInstance(trans, Eigen::Vector3f(-getVerticalBorderWidth(), 0, 0), false, false);
 	
 	//right border
-	mVerticalImage.setPosition(mSize.x(), 0);
-	mVerticalImage.setFlipX(true);
-	mVerticalImage.render(trans);
+	mVerticalImage.renderInstance(trans, Eigen::Vector3f(mSize.x(), 0, 0), true, false);
 	
 	//top border
-	mHorizontalImage.setPosition(0, -getHorizontalBorderWidth());
-	mHorizontalImage.setFlipY(false);
-	mHorizontalImage.render(trans);
+	mHorizontalImage.renderInstance(trans, Eigen::Vector3f(0, -getHorizontalBorderWidth(), 0), false, false);
 	
 	//bottom border
-	mHorizontalImage.setPosition(0, mSize.y());
-	mHorizontalImage.setFlipY(true);
-	mHorizontalImage.render(trans);
+	mHorizontalImage.renderInstance(trans, Eigen::Vector3f(0, mSize.y(), 0), false, true);
 
 
 	//corner top left
-	mCornerImage.setPosition(-getHorizontalBorderWidth(), -getVerticalBorderWidth());
-	mCornerImage.setFlipX(false);
-	mCornerImage.setFlipY(false);
-	mCornerImage.render(trans);
+	mCornerImage.renderInstance(trans, Eigen::Vector3f(-getHorizontalBorderWidth(), -getVerticalBorderWidth(), 0), false, false);
 
 	//top right
-	mCornerImage.setPosition(mSize.x(), mCornerImage.getPosition().y());
-	mCornerImage.setFlipX(true);
-	mCornerImage.render(trans);
+	mCornerImage.renderInstance(trans, Eigen::Vector3f(mSize.x(), -getVerticalBorderWidth(), 0), true, false);
 
 	//bottom right
-	mCornerImage.setPosition(mCornerImage.getPosition().x(), mSize.y());
-	mCornerImage.setFlipY(true);
-	mCornerImage.render(trans);
+	mCornerImage.renderInstance(trans, Eigen::Vector3f(mSize.x(), mSize.y(), 0), true, true);
 
 	//bottom left
-	mCornerImage.setPosition(-getHorizontalBorderWidth(), mCornerImage.getPosition().y());
-	mCornerImage.setFlipX(false);
-	mCornerImage.render(trans);
+	mCornerImage.renderInstance(trans, Eigen::Vector3f(-getHorizontalBorderWidth(), mSize.y(), 0), false, true);
 
 	GuiComponent::renderChildren(trans);
 }
@@ -136,6 +136,7 @@ void GuiFastSelect::setLetterID(int id)
 		id -= LETTERS.length();
 
 	mLetterID = (size_t)id;
+	markDirty();
 }
 
 void GuiFastSelect::setListPos()
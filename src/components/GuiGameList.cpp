@@ -32,7 +32,7 @@ GuiGameList::GuiGameList(Window* window) : GuiComponent(window),
 	mTransitionImage(window, 0.0f, 0.0f, "", (float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight(), true), 
 	mHeaderText(mWindow), 
     sortStateIndex(Settings::getInstance()->getInt("GameListSortIndex")),
-	mLockInput(false),
+	mLockInput(false), mPrefetchSelection(-1), mTransitionTargetIndex(0),
 	mEffectFunc(NULL), mEffectTime(0), mGameLaunchEffectLength(700)
 {
 	//first object initializes the vector
@@ -171,12 +171,14 @@ bool GuiGameList::input(InputConfig* config, Input input)
 	{
 		if(config->isMappedTo("right", input))
 		{
+			captureScreen();
 			setSystemId(mSystemId + 1);
 			doTransition(-1);
 			return true;
 		}
 		if(config->isMappedTo("left", input))
 		{
+			captureScreen();
 			setSystemId(mSystemId - 1);
 			doTransition(1);
 			return true;
@@ -386,7 +388,7 @@ void GuiGameList::updateDetailData()
 			if(((GameData*)mList.getSelectedObject())->getImagePath().empty())
 				mScreenshot.setImage(mTheme->getString("imageNotFoundPath"));
 			else
-				mScreenshot.setImage(((GameData*)mList.getSelectedObject())->getImagePath());
+				mScreenshot.setImage(((GameData*)mList.getSelectedObject())->getImagePath(), true); //decoded in the background, see update()
 
 			Eigen::Vector3f imgOffset = Eigen::Vector3f(Renderer::getScreenWidth() * 0.10f, 0, 0);
 			mScreenshot.setPosition(getImagePos() - imgOffset);
@@ -394,8 +396,7 @@ void GuiGameList::updateDetailData()
 			mImageAnimation.fadeIn(35);
 			mImageAnimation.move(imgOffset.x(), imgOffset.y(), 20);
 
-			mDescContainer.setPosition(Eigen::Vector3f(Renderer::getScreenWidth() * 0.03f, getImagePos().y() + mScreenshot.getSize().y() + 12, 0));
-			mDescContainer.setSize(Eigen::Vector2f(Renderer::getScreenWidth() * (mTheme->getFloat("listOffsetX") - 0.03f), Renderer::getScreenHeight() - mDescContainer.getPosition().y()));
+			updateDescriptionLayout();
 			mDescContainer.setScrollPos(Eigen::Vector2d(0, 0));
 			mDescContainer.resetAutoScrollTimer();
 
@@ -409,6 +410,45 @@ void GuiGameList::updateDetailData()
 	}
 }
 
+//starts decoding the screenshots of the games around the selection, dir is the direction the selection moved in
+void GuiGameList::prefetchScreenshots(int dir)
+{
+	std::vector< std::shared_ptr<TextureResource> > prefetched;
+
+	const int count = mList.getObjectCount();
+	const int selection = mList.getSelection();
+	for(int i = -SCREENSHOT_PREFETCH_BEHIND; i <= SCREENSHOT_PREFETCH_AHEAD && count > 0; i++)
+	{
+		if(i == 0)
+			continue;
+
+		//the list wraps around at the ends
+		int index = (selection + i * dir) % count;
+		if(index < 0)
+			index += count;
+		if(index == selection)
+			continue;
+
+		FileData* file = mList.getObject(index);
+		if(file->isFolder())
+			continue;
+
+		const std::string& path = ((GameData*)file)->getImagePath();
+		if(!path.empty() && mWindow->getResourceManager()->fileExists(path))
+			prefetched.push_back(TextureResource::getAsync(*mWindow->getResourceManager(), path, mScreenshot.getTargetSize())); //same size mScreenshot will ask for
+	}
+
+	//textures that were prefetched before and still are stay alive, everything else (including loads that haven't started yet) is dropped
+	mPrefetchedScreenshots.swap(prefetched);
+}
+
+//puts the description right below the screenshot
+void GuiGameList::updateDescriptionLayout()
+{
+	mDescContainer.setPosition(Eigen::Vector3f(Renderer::getScreenWidth() * 0.03f, getImagePos().y() + mScreenshot.getSize().y() + 12, 0));
+	mDescContainer.setSize(Eigen::Vector2f(Renderer::getScreenWidth() * (mTheme->getFloat("listOffsetX") - 0.03f), Renderer::getScreenHeight() - mDescContainer.getPosition().y()));
+}
+
 void GuiGameList::clearDetailData()
 {
 	if(isDetailed())
@@ -427,6 +467,8 @@ GuiGameList* GuiGameList::create(Window* window)
 
 void GuiGameList::update(int deltaTime)
 {
+	bool screenshotLoading = mScreenshot.isLoading();
+
 	mTransitionAnimation.update(deltaTime);
 	mImageAnimation.update(deltaTime);
 
@@ -437,11 +479,47 @@ void GuiGameList::update(int deltaTime)
 	}
 
 	GuiComponent::update(deltaTime);
+
+	if(!isDetailed())
+	{
+		mPrefetchedScreenshots.clear();
+		mPrefetchSelection = -1;
+	}else if(mList.getSelection() != mPrefetchSelection)
+	{
+		//moving by more than half the list means we wrapped around
+		int dir = (mList.getSelection() >= mPrefetchSelection) ? 1 : -1;
+		if(mPrefetchSelection != -1 && abs(mList.getSelection() - mPrefetchSelection) > mList.getObjectCount() / 2)
+			dir = -dir;
+
+		mPrefetchSelection = mList.getSelection();
+		prefetchScreenshots(dir);
+	}
+
+	//the screenshot finished loading and got its real size, move the description out of the way
+	if(screenshotLoading && !mScreenshot.isLoading() && isDetailed())
+		updateDescriptionLayout();
+}
+
+//puts what's on screen right now into mTransitionImage, has to happen before the list changes
+void GuiGameList::captureScreen()
+{
+	//the two targets take turns, so we never draw into the one mTransitionImage is showing
+	std::shared_ptr<TextureResource>& target = mTransitionTargets[mTransitionTargetIndex];
+	if(!target)
+		target = TextureResource::get(*mWindow->getResourceManager(), "");
+
+	if(mWindow->renderToTexture(*target))
+	{
+		mTransitionImage.setTexture(target);
+		mTransitionTargetIndex = (mTransitionTargetIndex + 1) % 2;
+	}else{
+		//no framebuffer objects, read back what we drew last frame
+		mTransitionImage.copyScreen();
+	}
 }
 
 void GuiGameList::doTransition(int dir)
 {
-	mTransitionImage.copyScreen();
 	mTransitionImage.setOpacity(255);
 
 	//put the image of what's currently onscreen at what will be (in screen coords) 0, 0
@@ -521,7 +599,7 @@ void GuiGameList::updateGameLaunchEffect(int t)
 	if(t > endTime)
 	{
 		//effect done
-		mTransitionImage.setImage(""); //fixes "tried to bind uninitialized texture!" since copyScreen()'d textures don't reinit
+		mTransitionImage.setImage(""); //fixes "tried to bind uninitialized texture!" since captured screens don't reinit
 		mSystem->launchGame(mWindow, (GameData*)mList.getSelectedObject());
 		mEffectFunc = &GuiGameList::updateGameReturnEffect;
 		mEffectTime = 0;
@@ -13,6 +13,10 @@
 #include "../GameData.h"
 #include "../FolderData.h"
 #include "ScrollableContainer.h"
+#include "../resources/TextureResource.h"
+
+#define SCREENSHOT_PREFETCH_AHEAD 3 //screenshots to decode ahead of the selection, in the direction the list was last scrolled
+#define SCREENSHOT_PREFETCH_BEHIND 1 //...and behind it, for changing your mind
 
 //This is where the magic happens - GuiGameList is the parent of almost every graphical element in ES at the moment.
 //It has a TextListComponent child that handles the game list, a ThemeComponent that handles the theming system, and an ImageComponent for game images.
@@ -48,6 +52,9 @@ private:
 	void updateList();
 	void updateTheme();
 	void clearDetailData();
+	void updateDescriptionLayout();
+	void prefetchScreenshots(int dir);
+	void captureScreen();
 	void doTransition(int dir);
 
 	std::string getThemeFile();
@@ -65,7 +72,14 @@ private:
 	ThemeComponent* mTheme;
 	TextComponent mHeaderText;
 
+	//keeps the screenshots around the selection alive (and decoding), so stopping on a game shows its image right away.
+	//at most SCREENSHOT_PREFETCH_AHEAD + SCREENSHOT_PREFETCH_BEHIND textures, the rest are freed as usual
+	std::vector< std::shared_ptr<TextureResource> > mPrefetchedScreenshots;
+	int mPrefetchSelection;
+
 	ImageComponent mTransitionImage;
+	std::shared_ptr<TextureResource> mTransitionTargets[2]; //render targets for mTransitionImage, reused between transitions
+	int mTransitionTargetIndex;
 	AnimationComponent mTransitionAnimation;
 
 	Eigen::Vector3f getImagePos();
@@ -14,6 +14,11 @@ Eigen::Vector2i ImageComponent::getTextureSize() const
 		return Eigen::Vector2i(0, 0);
 }
 
+Eigen::Vector2i ImageComponent::getTargetSize() const
+{
+	return Eigen::Vector2i((int)ceil(mTargetSize.x()), (int)ceil(mTargetSize.y()));
+}
+
 Eigen::Vector2f ImageComponent::getCenter() const
 {
 	return Eigen::Vector2f(mPosition.x() - (getSize().x() * mOrigin.x()) + getSize().x() / 2, 
@@ -21,7 +26,7 @@ Eigen::Vector2f ImageComponent::getCenter() const
 }
 
 ImageComponent::ImageComponent(Window* window, float offsetX, float offsetY, std::string path, float targetWidth, float targetHeight, bool allowUpscale) : GuiComponent(window), 
-	mTiled(false), mAllowUpscale(allowUpscale), mFlipX(false), mFlipY(false), mOrigin(0.5, 0.5), mTargetSize(targetWidth, targetHeight), mColorShift(0xFFFFFFFF)
+	mTiled(false), mAllowUpscale(allowUpscale), mFlipX(false), mFlipY(false), mOrigin(0.5, 0.5), mTargetSize(targetWidth, targetHeight), mColorShift(0xFFFFFFFF), mLoading(false)
 {
 	setPosition(offsetX, offsetY);
 
@@ -38,6 +43,17 @@ void ImageComponent::resize()
 	if(!mTexture)
 		return;
 
+	//no size yet, use the target size for the placeholder (square if only one axis is given)
+	if(mTexture->isLoading())
+	{
+		mSize = mTargetSize;
+		if(!mSize.x())
+			mSize[0] = mSize.y();
+		if(!mSize.y())
+			mSize[1] = mSize.x();
+		return;
+	}
+
 	mSize << (float)getTextureSize().x(), (float)getTextureSize().y();
 	
 	//(we don't resize tiled images)
@@ -69,21 +85,27 @@ void ImageComponent::resize()
 		mSize = mTargetSize;
 }
 
-void ImageComponent::setImage(std::string path)
+void ImageComponent::setImage(std::string path, bool async)
 {
 	mPath = path;
 
 	if(mPath.empty() || !mWindow->getResourceManager()->fileExists(mPath))
 		mTexture.reset();
+	else if(async && !mTiled)
+		mTexture = TextureResource::getAsync(*mWindow->getResourceManager(), mPath, getTargetSize()); //no need to keep more pixels than we show
 	else
-		mTexture = TextureResource::get(*mWindow->getResourceManager(), mPath);
+		mTexture = TextureResource::get(*mWindow->getResourceManager(), mPath, !mTiled); //tiling repeats the whole texture, so no atlas
+
+	mLoading = mTexture && mTexture->isLoading();
 
 	resize();
+	markDirty();
 }
 
 void ImageComponent::setOrigin(float originX, float originY)
 {
 	mOrigin << originX, originY;
+	markDirty();
 }
 
 void ImageComponent::setTiling(bool tile)
@@ -94,6 +116,7 @@ void ImageComponent::setTiling(bool tile)
 		mAllowUpscale = false;
 
 	resize();
+	markDirty();
 }
 
 void ImageComponent::setResize(float width, float height, bool allowUpscale)
@@ -101,21 +124,43 @@ void ImageComponent::setResize(float width, float height, bool allowUpscale)
 	mTargetSize << width, height;
 	mAllowUpscale = allowUpscale;
 	resize();
+	markDirty();
 }
 
 void ImageComponent::setFlipX(bool flip)
 {
 	mFlipX = flip;
+	markDirty();
 }
 
 void ImageComponent::setFlipY(bool flip)
 {
 	mFlipY = flip;
+	markDirty();
 }
 
 void ImageComponent::setColorShift(unsigned int color)
 {
 	mColorShift = color;
+	markDirty();
+}
+
+bool ImageComponent::isLoading() const
+{
+	return mLoading;
+}
+
+void ImageComponent::update(int deltaTime)
+{
+	//the loader finished our texture, now we know how big we are
+	if(mLoading && !mTexture->isLoading())
+	{
+		mLoading = false;
+		resize();
+		markDirty();
+	}
+
+	GuiComponent::update(deltaTime);
 }
 
 void ImageComponent::render(const Eigen::Affine3f& parentTrans)
@@ -123,30 +168,56 @@ void ImageComponent::render(const Eigen::Affine3f& parentTrans)
 	Eigen::Affine3f trans = parentTrans * getTransform();
 	Renderer::setMatrix(trans);
 	
-	if(mTexture && getOpacity() > 0)
+	drawImage(mFlipX, mFlipY);
+
+	GuiComponent::renderChildren(trans);
+}
+
+void ImageComponent::renderInstance(const Eigen::Affine3f& parentTrans, const Eigen::Vector3f& position, bool flipX, bool flipY)
+{
+	Eigen::Affine3f trans = parentTrans;
+	trans.translate(position);
+	Renderer::setMatrix(trans);
+
+	drawImage(flipX, flipY);
+}
+
+void ImageComponent::drawImage(bool flipX, bool flipY)
+{
+	if(mLoading && getOpacity() > 0)
+	{
+		//placeholder until the texture is decoded
+		Renderer::drawRect((int)(-mSize.x() * mOrigin.x()), (int)(-mSize.y() * mOrigin.y()), (int)mSize.x(), (int)mSize.y(), 0x00000000 | (getOpacity() / 4));
+	}else if(mTexture && getOpacity() > 0)
 	{
 		GLfloat points[12], texs[12];
-		GLubyte colors[6*4];
 
 		if(mTiled)
 		{
 			float xCount = mSize.x() / getTextureSize().x();
 			float yCount = mSize.y() / getTextureSize().y();
 			
-			Renderer::buildGLColorArray(colors, (mColorShift >> 8 << 8)| (getOpacity()), 6);
-			buildImageArray(0, 0, points, texs, xCount, yCount);
+			buildImageArray(0, 0, points, texs, flipX, flipY, xCount, yCount);
 		}else{
-			Renderer::buildGLColorArray(colors, (mColorShift >> 8 << 8) | (getOpacity()), 6);
-			buildImageArray(0, 0, points, texs);
+			buildImageArray(0, 0, points, texs, flipX, flipY);
 		}
 
-		drawImageArray(points, texs, colors, 6);
-	}
+		//images packed into an atlas or stored in a pooled texture only cover part of it
+		const Eigen::Vector4f rect = mTexture->getTextureRect();
+		if(rect != Eigen::Vector4f(0, 0, 1, 1))
+		{
+			for(int i = 0; i < 12; i += 2)
+			{
+				texs[i] = rect[0] + texs[i] * (rect[2] - rect[0]);
+				texs[i + 1] = rect[1] + texs[i + 1] * (rect[3] - rect[1]);
+			}
+		}
 
-	GuiComponent::renderChildren(trans);
+		Renderer::drawTexturedQuad(mTexture->getTextureID(), points, texs, (mColorShift >> 8 << 8) | (getOpacity()));
+	}
 }
 
-void ImageComponent::buildImageArray(int posX, int posY, GLfloat* points, GLfloat* texs, float px, float py)
+void ImageComponent::buildImageArray(int posX, int posY, GLfloat* points, GLfloat* texs, bool flipX, bool flipY, float px, float py)
 {
 	points[0] = posX - (mSize.x() * mOrigin.x());		points[1] = posY - (mSize.y() * mOrigin.y());
 	points[2] = posX - (mSize.x() * mOrigin.x());		points[3] = posY + (mSize.y() * (1 - mOrigin.y()));
@@ -166,7 +237,7 @@ void ImageComponent::buildImageArray(int posX, int posY, GLfloat* points, GLfloa
 	texs[8] = 0;		texs[9] = 0;
 	texs[10] = px;		texs[11] = 0;
 
-	if(mFlipX)
+	if(flipX)
 	{
 		for(int i = 0; i < 11; i += 2)
 			if(texs[i] == px)
@@ -174,7 +245,7 @@ void ImageComponent::buildImageArray(int posX, int posY, GLfloat* points, GLfloa
 			else
 				texs[i] = px;
 	}
-	if(mFlipY)
+	if(flipY)
 	{
 		for(int i = 1; i < 12; i += 2)
 			if(texs[i] == py)
@@ -184,50 +255,30 @@ void ImageComponent::buildImageArray(int posX, int posY, GLfloat* points, GLfloa
 	}
 }
 
-void ImageComponent::drawImageArray(GLfloat* points, GLfloat* texs, GLubyte* colors, unsigned int numArrays)
-{
-	mTexture->bind();
-
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	if(colors != NULL)
-	{
-		glEnableClientState(GL_COLOR_ARRAY);
-		glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors);
-	}
-
-	glVertexPointer(2, GL_FLOAT, 0, points);
-	glTexCoordPointer(2, GL_FLOAT, 0, texs);
-
-	glDrawArrays(GL_TRIANGLES, 0, numArrays);
-
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	if(colors != NULL)
-		glDisableClientState(GL_COLOR_ARRAY);
-
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_BLEND);
-}
-
 bool ImageComponent::hasImage()
 {
 	return !mPath.empty();
 }
 
 
+void ImageComponent::setTexture(const std::shared_ptr<TextureResource>& texture)
+{
+	mPath = "";
+	mTexture = texture;
+	mLoading = false;
+
+	resize();
+	markDirty();
+}
+
 void ImageComponent::copyScreen()
 {
 	mTexture.reset();
+	mLoading = false;
 
 	mTexture = TextureResource::get(*mWindow->getResourceManager(), "");
 	mTexture->initFromScreen();
 
 	resize();
+	markDirty();
 }
@@ -19,7 +19,8 @@ public:
 	virtual ~ImageComponent();
 
 	void copyScreen(); //Copy the entire screen into a texture for us to use.
-	void setImage(std::string path); //Loads the image at the given filepath.
+	void setTexture(const std::shared_ptr<TextureResource>& texture); //Shows texture, e.g. a render target.
+	void setImage(std::string path, bool async = false); //Loads the image at the given filepath. If async is true, the image is decoded in the background and a placeholder is drawn until it's done.
 	void setOrigin(float originX, float originY); //Sets the origin as a percentage of this image (e.g. (0, 0) is top left, (0.5, 0.5) is the center)
 	void setTiling(bool tile); //Enables or disables tiling. Must be called before loading an image or resizing will be weird.
 	void setResize(float width, float height, bool allowUpscale);
@@ -31,21 +32,31 @@ public:
 	//You can get the rendered size of the ImageComponent with getSize().
 	Eigen::Vector2i getTextureSize() const;
 
+	//The size set with setResize(), rounded up. Images loaded with async = true are decoded at no more than this size.
+	Eigen::Vector2i getTargetSize() const;
+
 	Eigen::Vector2f getCenter() const;
 
 	bool hasImage();
+	bool isLoading() const; //True while an image set with async = true is still being decoded.
 
+	void update(int deltaTime) override;
 	void render(const Eigen::Affine3f& parentTrans) override;
 
+	//Draws this image at position (relative to parentTrans) with the given flipping, ignoring the component's own position and flip settings.
+	//Doesn't change the component, so it can be used to draw one image several times per frame (see GuiBox).
+	void renderInstance(const Eigen::Affine3f& parentTrans, const Eigen::Vector3f& position, bool flipX, bool flipY);
+
 private:
 	Eigen::Vector2f mTargetSize;
 	Eigen::Vector2f mOrigin;
 
 	bool mAllowUpscale, mTiled, mFlipX, mFlipY;
+	bool mLoading; //waiting for an async texture, drawing a placeholder
 
 	void resize();
-	void buildImageArray(int x, int y, GLfloat* points, GLfloat* texs, float percentageX = 1, float percentageY = 1); //writes 12 GLfloat points and 12 GLfloat texture coordinates to a given array at a given position
-	void drawImageArray(GLfloat* points, GLfloat* texs, GLubyte* colors, unsigned int count = 6); //draws the given set of points and texture coordinates, number of coordinate pairs may be specified (default 6)
+	void buildImageArray(int x, int y, GLfloat* points, GLfloat* texs, bool flipX, bool flipY, float percentageX = 1, float percentageY = 1); //writes 12 GLfloat points and 12 GLfloat texture coordinates to a given array at a given position
+	void drawImage(bool flipX, bool flipY); //queues the image as a quad with the current renderer matrix
 
 	std::string mPath;
 
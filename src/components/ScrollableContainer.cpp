@@ -41,6 +41,7 @@ Eigen::Vector2d ScrollableContainer::getScrollPos() const
 void ScrollableContainer::setScrollPos(const Eigen::Vector2d& pos)
 {
 	mScrollPos = pos;
+	markDirty();
 }
 
 void ScrollableContainer::update(int deltaTime)
@@ -67,6 +68,7 @@ void ScrollableContainer::update(int deltaTime)
 		}
 	}
 
+	Eigen::Vector2d oldScrollPos = mScrollPos;
 	Eigen::Vector2d scroll = mScrollDir * scrollAmt;
 	mScrollPos += scroll;
 
@@ -83,6 +85,8 @@ void ScrollableContainer::update(int deltaTime)
 	if(mScrollPos.y() + getSize().y() > contentSize.y())
 		mScrollPos[1] = (double)contentSize.y() - getSize().y();
 
+	if(mScrollPos != oldScrollPos)
+		markDirty();
 	GuiComponent::update(deltaTime);
 }
 
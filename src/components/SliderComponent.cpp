@@ -58,6 +58,8 @@ void SliderComponent::update(int deltaTime)
 		if(mValue > mMax)
 			mValue = mMax;
 
+		markDirty();
+
 		if(mRepeatWaitTimer < 450)
 			mRepeatWaitTimer += deltaTime;
 	}
@@ -91,6 +93,7 @@ void SliderComponent::render(const Eigen::Affine3f& parentTrans)
 void SliderComponent::setValue(float value)
 {
 	mValue = value;
+	markDirty();
 }
 
 float SliderComponent::getValue()
@@ -44,4 +44,5 @@ bool SwitchComponent::getState()
 void SwitchComponent::setState(bool state)
 {
 	mState = state;
+	markDirty();
 }
@@ -28,12 +28,14 @@ void TextComponent::setFont(std::shared_ptr<Font> font)
 	mFont = font;
 
 	calculateExtent();
+	markDirty();
 }
 
 void TextComponent::setColor(unsigned int color)
 {
 	mColor = color;
 	mOpacity = mColor & 0x000000FF;
+	markDirty();
 }
 
 void TextComponent::setText(const std::string& text)
@@ -41,11 +43,13 @@ void TextComponent::setText(const std::string& text)
 	mText = text;
 
 	calculateExtent();
+	markDirty();
 }
 
 void TextComponent::setCentered(bool center)
 {
 	mCentered = center;
+	markDirty();
 }
 
 std::shared_ptr<Font> TextComponent::getFont() const
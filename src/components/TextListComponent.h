@@ -283,6 +283,7 @@ void TextListComponent<T>::update(int deltaTime)
 			{
 				mMarqueeOffset += MARQUEE_RATE;
 				mMarqueeTime -= MARQUEE_SPEED;
+				markDirty();
 			}
 		}
 	}
@@ -310,6 +311,8 @@ void TextListComponent<T>::scroll()
 			mSelection -= mRowVector.size();
 	}
 
+	markDirty();
+
 	if(mScrollSound)
 		mScrollSound->play();
 }
@@ -320,6 +323,7 @@ void TextListComponent<T>::addObject(std::string name, T obj, unsigned int color
 {
 	ListRow row = {name, obj, color};
 	mRowVector.push_back(row);
+	markDirty();
 }
 
 template <typename T>
@@ -329,6 +333,7 @@ void TextListComponent<T>::clear()
 	mSelection = 0;
 	mMarqueeOffset = 0;
 	mMarqueeTime = -MARQUEE_DELAY;
+	markDirty();
 }
 
 template <typename T>
@@ -365,24 +370,28 @@ template <typename T>
 void TextListComponent<T>::setSelectorColor(unsigned int selectorColor)
 {
 	mSelectorColor = selectorColor;
+	markDirty();
 }
 
 template <typename T>
 void TextListComponent<T>::setSelectedTextColor(unsigned int selectedColor)
 {
 	mSelectedTextColorOverride = selectedColor;
+	markDirty();
 }
 
 template<typename T>
 void TextListComponent<T>::setCentered(bool centered)
 {
 	mDrawCentered = centered;
+	markDirty();
 }
 
 template<typename T>
 void TextListComponent<T>::setTextOffsetX(int textoffsetx)
 {
 	mTextOffsetX = textoffsetx;
+	markDirty();
 }
 
 template <typename T>
@@ -401,6 +410,7 @@ template <typename T>
 void TextListComponent<T>::setSelection(int i)
 {
 	mSelection = i;
+	markDirty();
 }
 
 template <typename T>
@@ -413,6 +423,7 @@ template <typename T>
 void TextListComponent<T>::setFont(std::shared_ptr<Font> font)
 {
 	mFont = font;
+	markDirty();
 }
 
 #endif
@@ -7,6 +7,8 @@
 #include <sstream>
 #include "../Renderer.h"
 #include "../Log.h"
+#include "../Trace.h"
+#include "../StartupReport.h"
 
 unsigned int ThemeComponent::getColor(std::string name)
 {
@@ -131,6 +133,9 @@ void ThemeComponent::deleteComponents()
 
 	clearChildren();
 
+	//the atlas goes away as soon as the last image using it is gone
+	mAtlas.reset();
+
 	setDefaults();
 }
 
@@ -140,6 +145,9 @@ void ThemeComponent::readXML(std::string path, bool detailed)
 	if(mPath == path)
 		return;
 
+	TraceScope trace("ThemeComponent::readXML", path);
+	StartupPhase phase("theme load");
+
 	setDefaults();
 	deleteComponents();
 
@@ -233,6 +241,19 @@ void ThemeComponent::readXML(std::string path, bool detailed)
 	mDescFont = resolveFont(root.child("descriptionFont"), Font::getDefaultPath(), FONT_SIZE_SMALL);
 	mFastSelectFont = resolveFont(root.child("fastSelectFont"), Font::getDefaultPath(), FONT_SIZE_LARGE);
 
+	//pack the small images into an atlas before anything loads them on its own
+	std::vector<std::string> atlasImages;
+	if(!mBoxData.backgroundTiled)
+		atlasImages.push_back(mBoxData.backgroundPath);
+	if(!mBoxData.horizontalTiled)
+		atlasImages.push_back(mBoxData.horizontalPath);
+	if(!mBoxData.verticalTiled)
+		atlasImages.push_back(mBoxData.verticalPath);
+	atlasImages.push_back(mBoxData.cornerPath);
+	collectAtlasImages(root, atlasImages);
+
+	mAtlas = TextureAtlas::create(*mWindow->getResourceManager(), atlasImages);
+
 	//actually read the components
 	createComponentChildren(root, this);
 
@@ -251,6 +272,18 @@ void ThemeComponent::createComponentChildren(pugi::xml_node node, GuiComponent*
 	}
 }
 
+//recursively finds the paths of all untiled image components
+void ThemeComponent::collectAtlasImages(pugi::xml_node node, std::vector<std::string>& paths)
+{
+	for(pugi::xml_node data = node.child("component"); data; data = data.next_sibling("component"))
+	{
+		if(std::string(data.child("type").text().get()) == "image" && !data.child("tiled"))
+			paths.push_back(expandPath(data.child("path").text().get()));
+
+		collectAtlasImages(data, paths);
+	}
+}
+
 //takes an XML element definition and creates an object from it
 GuiComponent* ThemeComponent::createElement(pugi::xml_node data, GuiComponent* parent)
 {
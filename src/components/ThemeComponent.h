@@ -8,6 +8,7 @@
 #include "GuiBox.h"
 #include "../AudioManager.h"
 #include "../Font.h"
+#include "../resources/TextureAtlas.h"
 
 //This class loads an XML-defined list of GuiComponents.
 class ThemeComponent : public GuiComponent
@@ -35,6 +36,7 @@ private:
 	void deleteComponents();
 	void createComponentChildren(pugi::xml_node node, GuiComponent* parent);
 	GuiComponent* createElement(pugi::xml_node data, GuiComponent* parent);
+	void collectAtlasImages(pugi::xml_node node, std::vector<std::string>& paths);
 
 	//utility functions
 	std::string expandPath(std::string path);
@@ -53,6 +55,10 @@ private:
 	std::map<std::string, std::string> mStringMap;
 
 	GuiBoxData mBoxData;
+
+	//small, untiled theme images packed into shared textures. kept alive as long as the theme, so the
+	//images created from it (including GuiBoxes built later from getBoxData()) draw from its pages.
+	std::shared_ptr<TextureAtlas> mAtlas;
 	
 	std::shared_ptr<Font> mListFont;
 	std::shared_ptr<Font> mDescFont;
@@ -15,12 +15,23 @@
 #include "Window.h"
 #include "EmulationStation.h"
 #include "Settings.h"
+#include "resources/TextureLoader.h"
+#include "resources/TextureCache.h"
+#include "resources/TexturePool.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "StartupReport.h"
+#include "MemoryStats.h"
+#include "InputRecording.h"
+#include "FrameTimeStats.h"
 
 #ifdef _RPI_
 	#include <bcm_host.h>
 #endif
 
 #include <sstream>
+#include <algorithm>
+#include <chrono>
 
 namespace fs = boost::filesystem;
 
@@ -47,6 +58,9 @@ bool parseArgs(int argc, char* argv[], unsigned int* width, unsigned int* height
 			}else if(strcmp(argv[i], "--draw-framerate") == 0)
 			{
 				Settings::getInstance()->setBool("DRAWFRAMERATE", true);
+			}else if(strcmp(argv[i], "--draw-memory") == 0)
+			{
+				Settings::getInstance()->setBool("DRAWMEMORY", true);
 			}else if(strcmp(argv[i], "--no-exit") == 0)
 			{
 				Settings::getInstance()->setBool("DONTSHOWEXIT", true);
@@ -61,6 +75,47 @@ bool parseArgs(int argc, char* argv[], unsigned int* width, unsigned int* height
 			}else if(strcmp(argv[i], "--windowed") == 0)
 			{
 				Settings::getInstance()->setBool("WINDOWED", true);
+			}else if(strcmp(argv[i], "--sdf-fonts") == 0)
+			{
+				Settings::getInstance()->setBool("SDFFONTS", true);
+			}else if(strcmp(argv[i], "--no-vsync") == 0)
+			{
+				Settings::getInstance()->setBool("VSYNC", false);
+			}else if(strcmp(argv[i], "--max-fps") == 0)
+			{
+				Settings::getInstance()->setInt("MAXFPS", atoi(argv[i + 1]));
+				i++; //skip the argument value
+			}else if(strcmp(argv[i], "--benchmark-frames") == 0)
+			{
+				Settings::getInstance()->setInt("BENCHMARKFRAMES", atoi(argv[i + 1]));
+				i++; //skip the argument value
+			}else if(strcmp(argv[i], "--fixed-step") == 0)
+			{
+				Settings::getInstance()->setInt("FIXEDSTEP", atoi(argv[i + 1]));
+				i++; //skip the argument value
+			}else if(strcmp(argv[i], "--record-input") == 0)
+			{
+				Settings::getInstance()->setString("RECORDINPUT", argv[i + 1]);
+				i++; //skip the argument value
+			}else if(strcmp(argv[i], "--replay-input") == 0)
+			{
+				Settings::getInstance()->setString("REPLAYINPUT", argv[i + 1]);
+				i++; //skip the argument value
+			}else if(strcmp(argv[i], "--profile") == 0)
+			{
+				Settings::getInstance()->setBool("PROFILE", true);
+			}else if(strcmp(argv[i], "--profile-file") == 0)
+			{
+				Settings::getInstance()->setBool("PROFILE", true);
+				Settings::getInstance()->setString("PROFILEFILE", argv[i + 1]);
+				i++; //skip the argument value
+			}else if(strcmp(argv[i], "--profile-startup") == 0)
+			{
+				Settings::getInstance()->setBool("PROFILESTARTUP", true);
+			}else if(strcmp(argv[i], "--trace") == 0)
+			{
+				Settings::getInstance()->setString("TRACEFILE", argv[i + 1]);
+				i++; //skip the argument value
 			}else if(strcmp(argv[i], "--help") == 0)
 			{
 				std::cout << "EmulationStation, a graphical front-end for ROM browsing.\n";
@@ -70,11 +125,23 @@ bool parseArgs(int argc, char* argv[], unsigned int* width, unsigned int* height
 				std::cout << "--gamelist-only			skip automatic game detection, only read from gamelist.xml\n";
 				std::cout << "--ignore-gamelist		ignore the gamelist (useful for troubleshooting)\n";
 				std::cout << "--draw-framerate		display the framerate\n";
+				std::cout << "--draw-memory			display how much memory textures, fonts, sounds and game data use\n";
 				std::cout << "--no-exit			don't show the exit option in the menu\n";
 				std::cout << "--debug				even more logging\n";
 				std::cout << "--dimtime [seconds]		time to wait before dimming the screen (default 30, use 0 for never)\n";
-
-				#ifdef USE_OPENGL_DESKTOP
+				std::cout << "--sdf-fonts			render all sizes of a font from one distance field texture\n";
+				std::cout << "--no-vsync			don't wait for the vertical blank when swapping buffers\n";
+				std::cout << "--max-fps [fps]			limit the framerate (default 60, use 0 for no limit)\n";
+				std::cout << "--fixed-step [ms]		advance the UI by ms every frame and run as fast as possible, for repeatable benchmarks\n";
+				std::cout << "--record-input [path]		record all input with timestamps to path\n";
+				std::cout << "--replay-input [path]		replay recorded input instead of reading the real one, quit after it and print frame time statistics\n";
+				std::cout << "--profile			show how long components take to update and render\n";
+				std::cout << "--profile-file [path]		profile, and write the results to path on exit\n";
+				std::cout << "--profile-startup		log how long each part of startup takes, print it and quit after the first frame\n";
+				std::cout << "--trace [path]			record a timeline of loading and drawing, written to path as a Chrome trace on exit\n";
+				std::cout << "--benchmark-frames [n]		redraw every frame as fast as possible, quit after n frames and print the frame time\n";
+
+				#if defined(USE_OPENGL_DESKTOP) && !defined(USE_HEADLESS)
 					std::cout << "--windowed			not fullscreen\n";
 				#endif
 
@@ -88,6 +155,42 @@ bool parseArgs(int argc, char* argv[], unsigned int* width, unsigned int* height
 	return true;
 }
 
+//after the last change on screen, keep ticking for this long before blocking on input.
+//timers that run without changing anything visible (marquee and description scroll delays, holding a button
+//to finish input detection) have to run out first - the longest is the description scroll delay (1500ms + half the screen width).
+const int IDLE_TIMEOUT = 5000;
+
+//minimum length of a tick that didn't draw anything
+const int IDLE_TICK_TIME = 10;
+
+//a replay ends this long after its last event
+const int REPLAY_END_TIME = 2000;
+
+//SDL timer callback, wakes up the main loop from SDL_WaitEvent when it's time to dim the screen
+Uint32 wakeUpCallback(Uint32 interval, void* param)
+{
+	SDL_Event event;
+	event.type = SDL_USEREVENT;
+	event.user.code = 0;
+	event.user.data1 = NULL;
+	event.user.data2 = NULL;
+	SDL_PushEvent(&event);
+	return 0; //one-shot
+}
+
+//blocks until there's an event in the queue, or until timeout milliseconds have passed (0 waits forever)
+void waitForEvent(int timeout)
+{
+	SDL_TimerID timer = NULL;
+	if(timeout > 0)
+		timer = SDL_AddTimer(timeout, wakeUpCallback, NULL);
+
+	SDL_WaitEvent(NULL); //NULL leaves the event in the queue for the regular event loop
+
+	if(timer != NULL)
+		SDL_RemoveTimer(timer);
+}
+
 bool verifyHomeFolderExists()
 {
 	//make sure the config directory exists
@@ -122,6 +225,12 @@ int main(int argc, char* argv[])
 	unsigned int width = 0;
 	unsigned int height = 0;
 
+	//loads es_settings.cfg
+	{
+		StartupPhase phase("settings");
+		Settings::getInstance();
+	}
+
 	if(!parseArgs(argc, argv, &width, &height))
 		return 0;
 
@@ -137,6 +246,12 @@ int main(int argc, char* argv[])
 	Log::open();
 	LOG(LogInfo) << "EmulationStation - " << PROGRAM_VERSION_STRING;
 
+	Profiler::setEnabled(Settings::getInstance()->getBool("PROFILE"));
+
+	const std::string traceFile = Settings::getInstance()->getString("TRACEFILE");
+	if(!traceFile.empty())
+		Trace::enable(traceFile);
+
 	//always close the log and deinit the BCM library on exit
 	atexit(&onExit);
 
@@ -151,10 +266,13 @@ int main(int argc, char* argv[])
 	SDL_JoystickEventState(SDL_DISABLE);
 
 	//try loading the system config file
-	if(!SystemData::loadConfig(SystemData::getConfigPath(), true))
 	{
-		LOG(LogError) << "Error parsing system config file!";
-		return 1;
+		StartupPhase phase("config parse");
+		if(!SystemData::loadConfig(SystemData::getConfigPath(), true))
+		{
+			LOG(LogError) << "Error parsing system config file!";
+			return 1;
+		}
 	}
 
 	//make sure it wasn't empty
@@ -167,6 +285,7 @@ int main(int argc, char* argv[])
 	//choose which GUI to open depending on if an input configuration already exists
 	if(fs::exists(InputManager::getConfigPath()))
 	{
+		StartupPhase phase("game list");
 		GuiGameList::create(&window);
 	}else{
 		window.pushGui(new GuiDetectDevice(&window));
@@ -176,12 +295,69 @@ int main(int argc, char* argv[])
 	SDL_JoystickEventState(SDL_ENABLE);
 
 	bool sleeping = false;
-	unsigned int timeSinceLastEvent = 0;
+	int lastEventTime = SDL_GetTicks();
+	int lastRenderTime = lastEventTime;
 	int lastTime = 0;
 	bool running = true;
 
+	//frame pacing. with vsync the swap already waits for the display, the limit also covers ticks that don't draw anything
+	const int maxFps = Settings::getInstance()->getInt("MAXFPS");
+	const int frameTime = maxFps > 0 ? 1000 / maxFps : 0;
+
+	//benchmark mode: redraw on every tick without any waiting, dimming or idling, and quit after a fixed number of frames
+	const int benchmarkFrames = Settings::getInstance()->getInt("BENCHMARKFRAMES");
+	const int benchmarkStart = SDL_GetTicks();
+	int framesRendered = 0;
+
+	//fixed step mode: every tick advances the UI by exactly this many ms, no matter how long it really took, and runs as fast as possible
+	const int fixedStep = Settings::getInstance()->getInt("FIXEDSTEP");
+
+	const std::string recordFile = Settings::getInstance()->getString("RECORDINPUT");
+	if(!recordFile.empty() && !InputRecording::startRecording(recordFile))
+		return 1;
+
+	const std::string replayFile = Settings::getInstance()->getString("REPLAYINPUT");
+	if(!replayFile.empty() && !InputRecording::loadReplay(replayFile, window.getInputManager()->getNumJoysticks()))
+		return 1;
+	const bool replaying = InputRecording::isReplaying();
+
+	//benchmarks, fixed steps and replays draw every tick and never idle or dim the screen, so every run does the same work.
+	//frame times are collected for them
+	const bool continuous = benchmarkFrames > 0 || fixedStep > 0 || replaying;
+	FrameTimeStats frameStats;
+
+	//ms since the loop started, simulated in fixed step mode. input recordings use this as their clock
+	const int loopStart = SDL_GetTicks();
+	int loopTime = 0;
+	unsigned int tick = 0;
+
+	//ended by the first frame that gets drawn
+	StartupReport::beginPhase("first frame");
+	const bool profileStartup = Settings::getInstance()->getBool("PROFILESTARTUP");
+
 	while(running)
 	{
+		int frameStart = SDL_GetTicks();
+		const std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+
+		//nothing on screen has changed for a while (or the screen is dimmed) - instead of ticking, sleep until something happens
+		if(!continuous && (sleeping || (!window.isDirty() && frameStart - lastRenderTime >= IDLE_TIMEOUT)))
+		{
+			const int dimTime = Settings::getInstance()->getInt("DIMTIME");
+			int timeout = 0;
+			if(!sleeping && dimTime != 0)
+				timeout = std::max(1, lastEventTime + dimTime - frameStart);
+
+			waitForEvent(timeout);
+
+			//don't let animations jump ahead by the time we were asleep
+			window.normalizeNextUpdate();
+			frameStart = SDL_GetTicks();
+		}
+
+		loopTime = fixedStep > 0 ? tick * fixedStep : SDL_GetTicks() - loopStart;
+		tick++;
+
 		SDL_Event event;
 		while(SDL_PollEvent(&event))
 		{
@@ -193,10 +369,15 @@ int main(int argc, char* argv[])
 				case SDL_KEYDOWN:
 				case SDL_KEYUP:
 				case SDL_JOYAXISMOTION:
+					//a replay is the only input while it runs
+					if(replaying)
+						break;
+
+					InputRecording::record(event, loopTime);
 					if(window.getInputManager()->parseEvent(event))
 					{
 						sleeping = false;
-						timeSinceLastEvent = 0;
+						lastEventTime = SDL_GetTicks();
 					}
 					break;
 				case SDL_USEREVENT:
@@ -209,10 +390,19 @@ int main(int argc, char* argv[])
 			}
 		}
 
+		if(replaying)
+		{
+			while(InputRecording::getNextEvent(loopTime, &event))
+				window.getInputManager()->parseEvent(event);
+
+			//give the last input some time to play out its animations
+			if(InputRecording::isReplayFinished() && loopTime >= InputRecording::getReplayEndTime() + REPLAY_END_TIME)
+				running = false;
+		}
+
 		if(sleeping)
 		{
 			lastTime = SDL_GetTicks();
-			SDL_Delay(1); //this doesn't need to be accurate
 			continue;
 		}
 
@@ -224,25 +414,104 @@ int main(int argc, char* argv[])
 		if(deltaTime > 1000 || deltaTime < 0)
 			deltaTime = 1000;
 
+		if(fixedStep > 0)
+			deltaTime = fixedStep;
+
+		Profiler::beginFrame();
 		window.update(deltaTime);
-		Renderer::swapBuffers(); //swap here so we can read the last screen state during updates (see ImageComponent::copyScreen())
-		window.render();
+
+		//only draw when something changed, a static screen doesn't need to be redrawn over and over
+		bool rendered = window.isDirty() || continuous;
+		if(rendered)
+		{
+			Profiler::pauseFrame();
+			{
+				TraceScope trace("Renderer::swapBuffers");
+				Renderer::swapBuffers(); //swap here so we can read the last screen state during updates (see ImageComponent::copyScreen())
+			}
+			Profiler::resumeFrame();
+			window.render();
+			lastRenderTime = SDL_GetTicks();
+			framesRendered++;
+
+			if(continuous)
+				frameStats.add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tickStart).count() / 1000.0f);
+		}
+		Profiler::endFrame(rendered);
+		Trace::checkSignal();
+
+		if(rendered && !StartupReport::isFinished())
+		{
+			StartupReport::finish();
+			MemoryStats::logStats();
+			if(profileStartup)
+			{
+				StartupReport::write(std::cout);
+				running = false;
+			}
+		}
+
+		if(benchmarkFrames > 0 && framesRendered >= benchmarkFrames)
+			running = false;
+
+		//benchmarks and fixed steps run as fast as possible, a replay in real time is paced like always
+		if(benchmarkFrames > 0 || fixedStep > 0)
+		{
+			Log::flush();
+			continue;
+		}
 
 		//sleep if we're past our threshold
 		//sleeping entails setting a flag to start skipping frames
 		//and initially drawing a black semi-transparent rect to dim the screen
-		timeSinceLastEvent += deltaTime;
-		if(timeSinceLastEvent >= (unsigned int)Settings::getInstance()->getInt("DIMTIME") && Settings::getInstance()->getInt("DIMTIME") != 0)
+		const int dimTime = Settings::getInstance()->getInt("DIMTIME");
+		if(!continuous && dimTime != 0 && (int)SDL_GetTicks() - lastEventTime >= dimTime)
 		{
 			sleeping = true;
-			timeSinceLastEvent = 0;
 			Renderer::drawRect(0, 0, Renderer::getScreenWidth(), Renderer::getScreenHeight(), 0x000000A0);
 			Renderer::swapBuffers();
 		}
 
+		//wait out the rest of the frame. ticks that didn't draw anything wait at least a few ms even without a
+		//framerate limit, there's no point in polling input faster than that
+		int frameLength = frameTime;
+		if(!rendered && frameLength < IDLE_TICK_TIME)
+			frameLength = IDLE_TICK_TIME;
+
+		int elapsed = SDL_GetTicks() - frameStart;
+		if(elapsed < frameLength)
+			SDL_Delay(frameLength - elapsed);
+
 		Log::flush();
 	}
 
+	if(benchmarkFrames > 0)
+	{
+		const int benchmarkTime = SDL_GetTicks() - benchmarkStart;
+		LOG(LogInfo) << "Benchmark: " << framesRendered << " frames in " << benchmarkTime << "ms, " << (float)benchmarkTime / framesRendered << "ms per frame.";
+		std::cout << framesRendered << " frames in " << benchmarkTime << "ms, " << (float)benchmarkTime / framesRendered << "ms per frame\n";
+	}
+
+	if(continuous)
+	{
+		LOG(LogInfo) << "Frame times: " << frameStats.getSummary();
+		std::cout << "frame times: " << frameStats.getSummary() << "\n";
+	}
+
+	InputRecording::stopRecording();
+
+	const std::string profileFile = Settings::getInstance()->getString("PROFILEFILE");
+	if(Profiler::isEnabled() && !profileFile.empty())
+		Profiler::writeReport(profileFile);
+
+	Trace::write();
+
+	TextureLoader::getInstance()->shutdown();
+	MemoryStats::logStats();
+	TextureCache::getInstance()->logStats();
+	TextureCache::getInstance()->clear();
+	TexturePool::getInstance()->logStats();
+	TexturePool::getInstance()->clear();
 	Renderer::deinit();
 	SystemData::deleteSystems();
 
@@ -2,6 +2,13 @@
 #include <stdlib.h>
 #include <boost/filesystem.hpp>
 
+#ifdef WIN32
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
 
 std::string getHomePath()
 {
@@ -36,3 +43,44 @@ std::string getHomePath()
 	boost::filesystem::path genericPath(homePath);
 	return genericPath.generic_string();
 }
+
+long long getProcessCpuTime()
+{
+#ifdef WIN32
+	FILETIME creation, exitTime, kernel, user;
+	if(!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user))
+		return 0;
+
+	//FILETIMEs count 100ns intervals
+	const long long kernelTime = ((long long)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+	const long long userTime = ((long long)user.dwHighDateTime << 32) | user.dwLowDateTime;
+	return (kernelTime + userTime) / 10;
+#else
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	return (long long)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+size_t getPeakMemoryUsage()
+{
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return counters.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	#ifdef __APPLE__
+		return usage.ru_maxrss; //bytes on OS X...
+	#else
+		return (size_t)usage.ru_maxrss * 1024; //...and kilobytes everywhere else
+	#endif
+#endif
+}
@@ -1,9 +1,16 @@
 //the Makefiles define these via command line
 //#define USE_OPENGL_ES
+//#define USE_OPENGL_ES2 (together with USE_OPENGL_ES)
 //#define USE_OPENGL_DESKTOP
+//#define USE_HEADLESS (together with USE_OPENGL_DESKTOP, offscreen rendering with Renderer_init_headless.cpp)
+//#define USE_SHADERS (draw with Renderer_pipeline_shader.cpp instead of Renderer_pipeline_fixed.cpp)
 
 #ifdef USE_OPENGL_ES
-	#define GLHEADER <GLES/gl.h>
+	#ifdef USE_OPENGL_ES2
+		#define GLHEADER <GLES2/gl2.h>
+	#else
+		#define GLHEADER <GLES/gl.h>
+	#endif
 #endif
 
 #ifdef USE_OPENGL_DESKTOP
@@ -17,4 +24,10 @@
 
 #include <string>
 
-std::string getHomePath();
\ No newline at end of file
+std::string getHomePath();
+
+//CPU time the whole process (all threads) has used so far, in microseconds.
+long long getProcessCpuTime();
+
+//The most physical memory the process has used so far (peak resident set size), in bytes. 0 if it isn't known.
+size_t getPeakMemoryUsage();
@@ -0,0 +1,265 @@
+#include "TextureAtlas.h"
+#include "../Log.h"
+#include "../ImageIO.h"
+#include "../Renderer.h"
+#include "../Profiler.h"
+#include "../MemoryStats.h"
+#include <algorithm>
+#include <iterator>
+#include <string.h>
+
+std::list< std::weak_ptr<TextureAtlas> > TextureAtlas::sAtlases;
+
+TextureAtlas::TextureAtlas()
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	deinit();
+}
+
+std::shared_ptr<TextureAtlas> TextureAtlas::create(ResourceManager& rm, const std::vector<std::string>& paths)
+{
+	std::shared_ptr<TextureAtlas> atlas(new TextureAtlas());
+
+	//decode everything to find out how big it is
+	std::vector<Entry> entries;
+	for(unsigned int i = 0; i < paths.size(); i++)
+	{
+		if(paths.at(i).empty())
+			continue;
+
+		bool duplicate = false;
+		for(unsigned int j = 0; j < entries.size(); j++)
+		{
+			if(entries.at(j).path == paths.at(i))
+				duplicate = true;
+		}
+		if(duplicate)
+			continue;
+
+		const ResourceData data = rm.getFileData(paths.at(i));
+		if(data.length == 0)
+			continue;
+
+		size_t width, height;
+		std::vector<unsigned char> imageRGBA = ImageIO::loadFromMemoryRGBA32(data.ptr.get(), data.length, width, height);
+		if(imageRGBA.empty() || width > ATLAS_MAX_IMAGE_SIZE || height > ATLAS_MAX_IMAGE_SIZE)
+			continue;
+
+		Entry entry;
+		entry.path = paths.at(i);
+		entry.page = 0;
+		entry.pos = Eigen::Vector2i::Zero();
+		entry.size << (int)width, (int)height;
+		entry.pixels.swap(imageRGBA); //kept until the first upload so we don't decode everything twice
+		entries.push_back(entry);
+	}
+
+	if(entries.empty() || !atlas->pack(entries))
+		return NULL;
+
+	atlas->upload(rm);
+
+	rm.addReloadable(atlas);
+	sAtlases.push_back(atlas);
+
+	LOG(LogInfo) << "Packed " << atlas->mEntries.size() << " images into " << atlas->mPages.size() << " atlas page(s).";
+	return atlas;
+}
+
+std::shared_ptr<TextureAtlas> TextureAtlas::find(const std::string& path)
+{
+	//newest first, an old atlas may still be alive while its images are being replaced
+	auto iter = sAtlases.rbegin();
+	while(iter != sAtlases.rend())
+	{
+		std::shared_ptr<TextureAtlas> atlas = iter->lock();
+		if(!atlas)
+		{
+			//erase through the base iterator, which points one past the element
+			iter = std::list< std::weak_ptr<TextureAtlas> >::reverse_iterator(sAtlases.erase(std::next(iter).base()));
+			continue;
+		}
+
+		if(atlas->contains(path))
+			return atlas;
+
+		iter++;
+	}
+
+	return NULL;
+}
+
+//simple shelf packing: tallest images first, fill rows left to right, start a new page when a page is full
+bool TextureAtlas::pack(std::vector<Entry>& entries)
+{
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.size.y() > b.size.y(); });
+
+	unsigned int page = 0;
+	int x = 0, y = 0, rowHeight = 0;
+	for(unsigned int i = 0; i < entries.size(); i++)
+	{
+		Entry& entry = entries.at(i);
+		const int w = entry.size.x() + ATLAS_PADDING * 2;
+		const int h = entry.size.y() + ATLAS_PADDING * 2;
+
+		if(x + w > ATLAS_PAGE_SIZE)
+		{
+			x = 0;
+			y += rowHeight;
+			rowHeight = 0;
+		}
+
+		if(y + h > ATLAS_PAGE_SIZE)
+		{
+			page++;
+			x = 0;
+			y = 0;
+			rowHeight = 0;
+		}
+
+		entry.page = page;
+		entry.pos << x + ATLAS_PADDING, y + ATLAS_PADDING;
+
+		x += w;
+		if(h > rowHeight)
+			rowHeight = h;
+	}
+
+	mEntries.swap(entries);
+	mPages.resize(page + 1, 0);
+	return true;
+}
+
+void TextureAtlas::upload(const ResourceManager& rm)
+{
+	deinit();
+
+	for(unsigned int i = 0; i < mPages.size(); i++)
+	{
+		glGenTextures(1, &mPages[i]);
+		Renderer::bindTexture(mPages[i]);
+
+		//start out transparent, so unused space doesn't show garbage when filtered into
+		std::vector<unsigned char> empty(ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE * 4, 0);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, empty.data());
+		MemoryStats::add(MemoryStats::CATEGORY_TEXTURES, ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE * 4);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	std::vector<unsigned char> padded;
+	for(unsigned int i = 0; i < mEntries.size(); i++)
+	{
+		Entry& entry = mEntries.at(i);
+
+		std::vector<unsigned char> imageRGBA;
+		if(!entry.pixels.empty())
+		{
+			imageRGBA.swap(entry.pixels);
+		}else{
+			//reloading, decode again
+			const ResourceData data = rm.getFileData(entry.path);
+			size_t width = 0, height = 0;
+			if(data.length != 0)
+				imageRGBA = ImageIO::loadFromMemoryRGBA32(data.ptr.get(), data.length, width, height);
+
+			if(imageRGBA.empty() || (int)width != entry.size.x() || (int)height != entry.size.y())
+			{
+				LOG(LogError) << "Image \"" << entry.path << "\" changed or disappeared since its atlas was built!";
+				continue;
+			}
+		}
+
+		//copy into a buffer with a border of repeated edge pixels
+		const int pw = entry.size.x() + ATLAS_PADDING * 2;
+		const int ph = entry.size.y() + ATLAS_PADDING * 2;
+		padded.resize(pw * ph * 4);
+		for(int py = 0; py < ph; py++)
+		{
+			const int sy = std::min(std::max(py - ATLAS_PADDING, 0), entry.size.y() - 1);
+			for(int px = 0; px < pw; px++)
+			{
+				const int sx = std::min(std::max(px - ATLAS_PADDING, 0), entry.size.x() - 1);
+				memcpy(&padded[(py * pw + px) * 4], &imageRGBA[(sy * entry.size.x() + sx) * 4], 4);
+			}
+		}
+
+		Renderer::bindTexture(mPages.at(entry.page));
+		Profiler::count(Profiler::COUNTER_TEXTURE_UPLOADS);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, entry.pos.x() - ATLAS_PADDING, entry.pos.y() - ATLAS_PADDING, pw, ph, GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+	}
+}
+
+void TextureAtlas::deinit()
+{
+	for(unsigned int i = 0; i < mPages.size(); i++)
+	{
+		if(mPages[i] != 0)
+		{
+			Renderer::deleteTexture(mPages[i]);
+			MemoryStats::remove(MemoryStats::CATEGORY_TEXTURES, ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE * 4);
+			mPages[i] = 0;
+		}
+	}
+}
+
+void TextureAtlas::unload(const ResourceManager& rm)
+{
+	deinit();
+}
+
+void TextureAtlas::reload(const ResourceManager& rm)
+{
+	upload(rm);
+}
+
+const TextureAtlas::Entry* TextureAtlas::getEntry(const std::string& path) const
+{
+	for(unsigned int i = 0; i < mEntries.size(); i++)
+	{
+		if(mEntries.at(i).path == path)
+			return &mEntries.at(i);
+	}
+
+	return NULL;
+}
+
+bool TextureAtlas::contains(const std::string& path) const
+{
+	return getEntry(path) != NULL;
+}
+
+GLuint TextureAtlas::getTextureID(const std::string& path) const
+{
+	const Entry* entry = getEntry(path);
+	return entry ? mPages.at(entry->page) : 0;
+}
+
+Eigen::Vector2i TextureAtlas::getImageSize(const std::string& path) const
+{
+	const Entry* entry = getEntry(path);
+	return entry ? entry->size : Eigen::Vector2i(0, 0);
+}
+
+Eigen::Vector4f TextureAtlas::getTextureRect(const std::string& path) const
+{
+	const Entry* entry = getEntry(path);
+	if(!entry)
+		return Eigen::Vector4f(0, 0, 1, 1);
+
+	const float size = (float)ATLAS_PAGE_SIZE;
+	return Eigen::Vector4f(entry->pos.x() / size, entry->pos.y() / size,
+		(entry->pos.x() + entry->size.x()) / size, (entry->pos.y() + entry->size.y()) / size);
+}
+
+unsigned int TextureAtlas::getPageCount() const
+{
+	return mPages.size();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ResourceManager.h"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <Eigen/Dense>
+#include "../platform.h"
+#include GLHEADER
+
+#define ATLAS_PAGE_SIZE 1024
+#define ATLAS_MAX_IMAGE_SIZE 256 //images bigger than this in either direction keep their own texture
+#define ATLAS_PADDING 1 //border around each image, filled with its edge pixels so linear filtering doesn't bleed between images
+
+//Packs a set of small images into a few shared texture pages.
+//While an atlas is alive, TextureResource::get() hands out sub-rectangles of its pages for the images it contains
+//instead of loading them into textures of their own, so they can be drawn (and batched) with the same texture.
+//Images that will be tiled can't be packed, the texture coordinates would repeat over the whole page.
+class TextureAtlas : public IReloadable
+{
+public:
+	//Decodes and packs the given images. Images that can't be loaded or are too big are skipped.
+	static std::shared_ptr<TextureAtlas> create(ResourceManager& rm, const std::vector<std::string>& paths);
+
+	//Returns the newest live atlas containing path, or NULL.
+	static std::shared_ptr<TextureAtlas> find(const std::string& path);
+
+	virtual ~TextureAtlas();
+
+	void unload(const ResourceManager& rm) override;
+	void reload(const ResourceManager& rm) override;
+
+	bool contains(const std::string& path) const;
+
+	GLuint getTextureID(const std::string& path) const;
+	Eigen::Vector2i getImageSize(const std::string& path) const;
+	Eigen::Vector4f getTextureRect(const std::string& path) const; //x1, y1, x2, y2 in texture coordinates
+
+	unsigned int getPageCount() const;
+
+private:
+	TextureAtlas();
+
+	struct Entry
+	{
+		std::string path;
+		unsigned int page;
+		Eigen::Vector2i pos; //top left of the image itself (padding not included)
+		Eigen::Vector2i size;
+		std::vector<unsigned char> pixels; //decoded image, only until the first upload
+	};
+
+	const Entry* getEntry(const std::string& path) const;
+	bool pack(std::vector<Entry>& entries);
+	void upload(const ResourceManager& rm);
+	void deinit();
+
+	std::vector<Entry> mEntries;
+	std::vector<GLuint> mPages;
+
+	static std::list< std::weak_ptr<TextureAtlas> > sAtlases;
+};
@@ -0,0 +1,112 @@
+#include "TextureCache.h"
+#include "TextureResource.h"
+#include "../Settings.h"
+#include "../Log.h"
+
+TextureCache* TextureCache::sInstance = NULL;
+
+TextureCache* TextureCache::getInstance()
+{
+	if(sInstance == NULL)
+		sInstance = new TextureCache();
+
+	return sInstance;
+}
+
+TextureCache::TextureCache() : mTotalBytes(0), mHits(0), mMisses(0), mEvictions(0)
+{
+}
+
+void TextureCache::touch(const std::shared_ptr<TextureResource>& texture)
+{
+	for(auto it = mTextures.begin(); it != mTextures.end(); it++)
+	{
+		if(*it == texture)
+		{
+			mTextures.splice(mTextures.begin(), mTextures, it);
+			trim();
+			return;
+		}
+	}
+
+	mTextures.push_front(texture);
+	trim();
+}
+
+void TextureCache::addBytes(size_t bytes)
+{
+	mTotalBytes += bytes;
+}
+
+void TextureCache::removeBytes(size_t bytes)
+{
+	mTotalBytes = (bytes > mTotalBytes) ? 0 : mTotalBytes - bytes;
+}
+
+void TextureCache::trim()
+{
+	const size_t budget = getBudget();
+
+	auto it = mTextures.end();
+	while(mTotalBytes > budget && it != mTextures.begin())
+	{
+		it--;
+
+		//only we know about it, so nobody will notice it's gone
+		if(it->use_count() == 1)
+		{
+			it = mTextures.erase(it); //deletes the texture, which takes its bytes off mTotalBytes
+			mEvictions++;
+		}
+	}
+}
+
+void TextureCache::clear()
+{
+	mTextures.clear();
+}
+
+void TextureCache::recordHit()
+{
+	mHits++;
+}
+
+void TextureCache::recordMiss()
+{
+	mMisses++;
+}
+
+size_t TextureCache::getBudget() const
+{
+	int megabytes = Settings::getInstance()->getInt("TextureCacheSize");
+	if(megabytes < 0)
+		megabytes = 0;
+
+	return (size_t)megabytes * 1024 * 1024;
+}
+
+size_t TextureCache::getTotalBytes() const
+{
+	return mTotalBytes;
+}
+
+unsigned int TextureCache::getHits() const
+{
+	return mHits;
+}
+
+unsigned int TextureCache::getMisses() const
+{
+	return mMisses;
+}
+
+unsigned int TextureCache::getEvictions() const
+{
+	return mEvictions;
+}
+
+void TextureCache::logStats() const
+{
+	LOG(LogInfo) << "Texture cache: " << mHits << " hits, " << mMisses << " misses, " << mEvictions << " evictions, "
+		<< mTextures.size() << " textures cached, " << (mTotalBytes / 1024) << "kB of " << (getBudget() / 1024) << "kB used";
+}
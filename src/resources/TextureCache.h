@@ -0,0 +1,51 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <cstddef>
+
+class TextureResource;
+
+//Keeps recently used textures alive after the last component lets go of them, so going back to a game or theme doesn't reload its images.
+//All texture memory is counted against the "TextureCacheSize" setting (in MB). When it's exceeded, cached textures are freed
+//least recently used first. Textures something else still holds on to are pinned - they can't be freed, but still count.
+class TextureCache
+{
+public:
+	static TextureCache* getInstance();
+
+	//Marks texture as just used, adding it to the cache if needed. Frees old textures if we're over budget.
+	void touch(const std::shared_ptr<TextureResource>& texture);
+
+	//Texture memory bookkeeping, called by TextureResource when it creates or deletes GL textures.
+	void addBytes(size_t bytes);
+	void removeBytes(size_t bytes);
+
+	//Frees least recently used textures that aren't pinned until we're within budget (or nothing is left to free).
+	void trim();
+
+	//Drops every cached texture. Textures that are still in use stay alive.
+	void clear();
+
+	void recordHit();
+	void recordMiss();
+
+	size_t getBudget() const;
+	size_t getTotalBytes() const;
+	unsigned int getHits() const;
+	unsigned int getMisses() const;
+	unsigned int getEvictions() const;
+
+	void logStats() const;
+
+private:
+	TextureCache();
+
+	std::list< std::shared_ptr<TextureResource> > mTextures; //most recently used first
+	size_t mTotalBytes; //all live textures, cached or not
+	unsigned int mHits;
+	unsigned int mMisses;
+	unsigned int mEvictions;
+
+	static TextureCache* sInstance;
+};
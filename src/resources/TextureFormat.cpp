@@ -0,0 +1,305 @@
+#include "TextureFormat.h"
+#include "../Settings.h"
+#include "../GLExtensions.h"
+#include "../Log.h"
+#include "../Profiler.h"
+#include <stdint.h>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+//ETC1 intensity modifiers, one row per table codeword. pixel index 0 adds [0], 1 adds [1], 2 subtracts [0], 3 subtracts [1]
+static const int etc1Modifiers[8][2] = { {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183} };
+
+TextureFormat::Format TextureFormat::getArtworkFormat()
+{
+	const std::string setting = Settings::getInstance()->getString("TextureFormat");
+
+	if(setting == "etc1")
+	{
+		if(GLExtensions::hasETC1())
+			return ETC1;
+
+		static bool warned = false;
+		if(!warned)
+		{
+			LOG(LogWarning) << "ETC1 textures are not supported by this GL implementation, using 16 bit textures instead.";
+			warned = true;
+		}
+		return RGB565;
+	}
+
+	if(setting == "16bit")
+		return RGB565;
+
+	return RGBA8888;
+}
+
+bool TextureFormat::isOpaque(const std::vector<unsigned char>& pixels)
+{
+	for(size_t i = 3; i < pixels.size(); i += 4)
+	{
+		if(pixels[i] != 255)
+			return false;
+	}
+
+	return true;
+}
+
+TextureFormat::Format TextureFormat::convert(std::vector<unsigned char>& pixels, size_t width, size_t height, Format requested)
+{
+	if(requested == RGBA8888 || pixels.size() != width * height * 4)
+		return RGBA8888;
+
+	Format format = requested;
+	if((format == RGB565 || format == ETC1 || format == RGBA4444) && !isOpaque(pixels))
+		format = RGBA4444;
+
+	//converted in place - every format is smaller than RGBA8888, so the output never overtakes the pixels still to be read.
+	//that way the buffer (and its capacity) can be reused for the next image. a 1x1 image is the exception, its ETC1 block is bigger.
+	const size_t convertedSize = getDataSize(format, width, height);
+	if(pixels.size() < convertedSize)
+		pixels.resize(convertedSize);
+	unsigned char* converted = pixels.data();
+
+	if(format == ETC1)
+	{
+		//4x4 blocks, row by row. images that aren't a multiple of 4 repeat their last row/column
+		const size_t blocksX = (width + 3) / 4;
+		const size_t blocksY = (height + 3) / 4;
+		unsigned char block[16 * 4];
+		for(size_t by = 0; by < blocksY; by++)
+		{
+			for(size_t bx = 0; bx < blocksX; bx++)
+			{
+				for(size_t y = 0; y < 4; y++)
+				{
+					const size_t srcY = std::min(by * 4 + y, height - 1);
+					for(size_t x = 0; x < 4; x++)
+					{
+						const size_t srcX = std::min(bx * 4 + x, width - 1);
+						memcpy(block + (y * 4 + x) * 4, pixels.data() + (srcY * width + srcX) * 4, 4);
+					}
+				}
+
+				encodeETC1Block(block, converted + (by * blocksX + bx) * 8);
+			}
+		}
+	}else{
+		uint16_t* out = (uint16_t*)converted;
+		const unsigned char* in = pixels.data();
+		const size_t count = width * height;
+		if(format == RGB565)
+		{
+			for(size_t i = 0; i < count; i++, in += 4)
+				out[i] = (uint16_t)(((in[0] >> 3) << 11) | ((in[1] >> 2) << 5) | (in[2] >> 3));
+		}else{
+			for(size_t i = 0; i < count; i++, in += 4)
+				out[i] = (uint16_t)(((in[0] >> 4) << 12) | ((in[1] >> 4) << 8) | ((in[2] >> 4) << 4) | (in[3] >> 4));
+		}
+	}
+
+	pixels.resize(convertedSize);
+	return format;
+}
+
+size_t TextureFormat::getDataSize(Format format, size_t width, size_t height)
+{
+	switch(format)
+	{
+	case RGB565:
+	case RGBA4444:
+		return width * height * 2;
+	case ETC1:
+		return ((width + 3) / 4) * ((height + 3) / 4) * 8;
+	default:
+		return width * height * 4;
+	}
+}
+
+void TextureFormat::upload(Format format, size_t width, size_t height, const unsigned char* data)
+{
+	if(data != NULL)
+		Profiler::count(Profiler::COUNTER_TEXTURE_UPLOADS);
+
+	//16 bit rows don't have to be a multiple of 4 bytes long
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	switch(format)
+	{
+	case RGB565:
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, data);
+		break;
+	case RGBA4444:
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, data);
+		break;
+	case ETC1:
+		glCompressedTexImage2D(GL_TEXTURE_2D, 0, GLExtensions::getETC1Format(), width, height, 0, getDataSize(format, width, height), data);
+		break;
+	default:
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		break;
+	}
+}
+
+void TextureFormat::uploadSubImage(Format format, size_t width, size_t height, const unsigned char* data)
+{
+	Profiler::count(Profiler::COUNTER_TEXTURE_UPLOADS);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	switch(format)
+	{
+	case RGB565:
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, data);
+		break;
+	case RGBA4444:
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, data);
+		break;
+	case ETC1:
+		LOG(LogError) << "ETC1 textures can't be updated, only replaced!";
+		break;
+	default:
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		break;
+	}
+}
+
+size_t TextureFormat::getPixelSize(Format format)
+{
+	switch(format)
+	{
+	case RGB565:
+	case RGBA4444:
+		return 2;
+	case ETC1:
+		return 0;
+	default:
+		return 4;
+	}
+}
+
+static inline int clampColor(int value)
+{
+	return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+//squared error of encoding the pixels with the given base color and table, fills indices (0-3) for each pixel
+static int encodeETC1Subblock(const unsigned char* const* pixels, const int* base, int table, int* indices)
+{
+	int totalError = 0;
+	for(int p = 0; p < 8; p++)
+	{
+		int bestError = INT_MAX;
+		for(int i = 0; i < 4; i++)
+		{
+			const int modifier = (i < 2) ? etc1Modifiers[table][i] : -etc1Modifiers[table][i - 2];
+			int error = 0;
+			for(int c = 0; c < 3; c++)
+			{
+				const int diff = clampColor(base[c] + modifier) - pixels[p][c];
+				error += diff * diff;
+			}
+
+			if(error < bestError)
+			{
+				bestError = error;
+				indices[p] = i;
+			}
+		}
+		totalError += bestError;
+	}
+
+	return totalError;
+}
+
+//a simple, fast encoder: individual mode only, the average color of each half as base color, best table and flip by brute force
+void TextureFormat::encodeETC1Block(const unsigned char* block, unsigned char* out)
+{
+	int bestError = INT_MAX;
+	int bestFlip = 0;
+	int bestBase[2][3] = {};
+	int bestTable[2] = {};
+	int bestIndices[2][8] = {};
+	int bestCoords[2][8][2] = {};
+
+	for(int flip = 0; flip < 2; flip++)
+	{
+		int error = 0;
+		int base[2][3];
+		int table[2];
+		int indices[2][8];
+		int coords[2][8][2];
+
+		for(int sub = 0; sub < 2; sub++)
+		{
+			//flip 0: two 2x4 halves side by side, flip 1: two 4x2 halves on top of each other
+			const unsigned char* pixels[8];
+			int sum[3] = { 0, 0, 0 };
+			for(int p = 0; p < 8; p++)
+			{
+				const int x = flip ? (p % 4) : (sub * 2 + p % 2);
+				const int y = flip ? (sub * 2 + p / 4) : (p / 2);
+				coords[sub][p][0] = x;
+				coords[sub][p][1] = y;
+				pixels[p] = block + (y * 4 + x) * 4;
+				for(int c = 0; c < 3; c++)
+					sum[c] += pixels[p][c];
+			}
+
+			//individual mode stores 4 bits per channel
+			for(int c = 0; c < 3; c++)
+			{
+				const int quantized = (sum[c] * 15 + 8 * 255 / 2) / (8 * 255);
+				base[sub][c] = (quantized << 4) | quantized;
+			}
+
+			int subError = INT_MAX;
+			int subIndices[8];
+			for(int t = 0; t < 8; t++)
+			{
+				const int e = encodeETC1Subblock(pixels, base[sub], t, subIndices);
+				if(e < subError)
+				{
+					subError = e;
+					table[sub] = t;
+					memcpy(indices[sub], subIndices, sizeof(subIndices));
+				}
+			}
+			error += subError;
+		}
+
+		if(error < bestError)
+		{
+			bestError = error;
+			bestFlip = flip;
+			memcpy(bestBase, base, sizeof(base));
+			memcpy(bestTable, table, sizeof(table));
+			memcpy(bestIndices, indices, sizeof(indices));
+			memcpy(bestCoords, coords, sizeof(coords));
+		}
+	}
+
+	out[0] = (unsigned char)(((bestBase[0][0] >> 4) << 4) | (bestBase[1][0] >> 4));
+	out[1] = (unsigned char)(((bestBase[0][1] >> 4) << 4) | (bestBase[1][1] >> 4));
+	out[2] = (unsigned char)(((bestBase[0][2] >> 4) << 4) | (bestBase[1][2] >> 4));
+	out[3] = (unsigned char)((bestTable[0] << 5) | (bestTable[1] << 2) | bestFlip); //diff bit (1) stays 0
+
+	//pixel indices are stored column by column, most significant bits in the upper half
+	uint32_t msb = 0, lsb = 0;
+	for(int sub = 0; sub < 2; sub++)
+	{
+		for(int p = 0; p < 8; p++)
+		{
+			const int bit = bestCoords[sub][p][0] * 4 + bestCoords[sub][p][1];
+			if(bestIndices[sub][p] & 2)
+				msb |= 1 << bit;
+			if(bestIndices[sub][p] & 1)
+				lsb |= 1 << bit;
+		}
+	}
+
+	out[4] = (unsigned char)(msb >> 8);
+	out[5] = (unsigned char)msb;
+	out[6] = (unsigned char)(lsb >> 8);
+	out[7] = (unsigned char)lsb;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+//Pixel formats textures can be stored in on the GPU. Decoded images are always RGBA8888 - artwork (game screenshots) can be converted
+//to a smaller format on the loader's worker threads, so more of it fits into the texture cache budget:
+//	RGBA8888 - 4 bytes per pixel, what everything else uses
+//	RGB565 - 2 bytes per pixel, no alpha
+//	RGBA4444 - 2 bytes per pixel, 4 bit alpha
+//	ETC1 - 0.5 bytes per pixel, compressed, no alpha. Only if the GL implementation supports it.
+//Images with transparency are never converted to a format without alpha, they fall back to RGBA4444.
+class TextureFormat
+{
+public:
+	enum Format { RGBA8888 = 0, RGB565 = 1, RGBA4444 = 2, ETC1 = 3 };
+
+	//The format artwork should be stored in, from the "TextureFormat" setting ("rgba8888", "16bit" or "etc1") and what the GL supports.
+	//Needs GLExtensions::init() to have run.
+	static Format getArtworkFormat();
+
+	//Converts RGBA8888 pixels in place to requested (or its fallback for images with transparency). Returns the format pixels are now in.
+	static Format convert(std::vector<unsigned char>& pixels, size_t width, size_t height, Format requested);
+
+	//Number of bytes an image in format takes up.
+	static size_t getDataSize(Format format, size_t width, size_t height);
+
+	//Uploads data to the currently bound texture. data may be NULL to only allocate storage (not for ETC1).
+	static void upload(Format format, size_t width, size_t height, const unsigned char* data);
+
+	//Replaces the bottom left width x height pixels of the currently bound texture, which has to be at least that big and in format.
+	//Not possible for ETC1 - GLES can't update parts of ETC1 textures.
+	static void uploadSubImage(Format format, size_t width, size_t height, const unsigned char* data);
+
+	//Bytes per pixel of the uncompressed formats, 0 for ETC1.
+	static size_t getPixelSize(Format format);
+
+private:
+	static bool isOpaque(const std::vector<unsigned char>& pixels);
+	static void encodeETC1Block(const unsigned char* block, unsigned char* out); //16 RGBA pixels, row by row -> 8 bytes
+};
@@ -0,0 +1,196 @@
+#include "TextureLoader.h"
+#include "TextureResource.h"
+#include "TextureCache.h"
+#include "ThumbnailCache.h"
+#include "../Settings.h"
+#include "ResourceManager.h"
+#include "../ImageIO.h"
+#include "../Log.h"
+#include "../Trace.h"
+#include <SDL.h>
+
+TextureLoader* TextureLoader::sInstance = NULL;
+
+TextureLoader* TextureLoader::getInstance()
+{
+	if(sInstance == NULL)
+		sInstance = new TextureLoader();
+
+	return sInstance;
+}
+
+TextureLoader::TextureLoader() : mDecoding(0), mStopping(false)
+{
+	//leave a core for the main thread, but don't go overboard - decoding is mostly limited by the SD card anyway
+	unsigned int threads = std::thread::hardware_concurrency();
+	threads = (threads > 1) ? threads - 1 : 1;
+	if(threads > 2)
+		threads = 2;
+
+	for(unsigned int i = 0; i < threads; i++)
+		mWorkers.push_back(std::thread(&TextureLoader::workerLoop, this));
+}
+
+TextureLoader::~TextureLoader()
+{
+	shutdown();
+}
+
+void TextureLoader::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+		mRequests.clear();
+	}
+	mCondition.notify_all();
+
+	for(unsigned int i = 0; i < mWorkers.size(); i++)
+	{
+		if(mWorkers.at(i).joinable())
+			mWorkers.at(i).join();
+	}
+	mWorkers.clear();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mResults.clear();
+	mFreeBuffers.clear();
+}
+
+void TextureLoader::load(const std::shared_ptr<TextureResource>& texture, const ResourceManager& rm)
+{
+	Request request;
+	request.texture = texture;
+	request.path = texture->getPath();
+	request.maxWidth = texture->mMaxSize.x();
+	request.maxHeight = texture->mMaxSize.y();
+	request.format = texture->mFormat;
+	request.useThumbnails = (request.maxWidth != 0 || request.maxHeight != 0) && Settings::getInstance()->getBool("ThumbnailCache"); //embedded images aren't on disk and are skipped by the cache
+	request.rm = &rm;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mRequests.push_back(request);
+	}
+	mCondition.notify_one();
+}
+
+void TextureLoader::workerLoop()
+{
+	while(true)
+	{
+		Request request;
+		Result result;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCondition.wait(lock, [this] { return mStopping || !mRequests.empty(); });
+			if(mStopping)
+				return;
+
+			request = mRequests.front();
+			mRequests.pop_front();
+
+			//nobody wants this anymore
+			if(request.texture.expired())
+				continue;
+
+			mDecoding++;
+
+			if(!mFreeBuffers.empty())
+			{
+				result.pixels.swap(mFreeBuffers.back());
+				mFreeBuffers.pop_back();
+			}
+		}
+
+		TraceScope trace("TextureLoader::decode", request.path);
+
+		result.texture = request.texture;
+		result.width = 0;
+		result.height = 0;
+		result.format = TextureFormat::RGBA8888;
+
+		//scaled down images are worth keeping on disk, decoding them again is a lot slower than reading the raw pixels
+		if(!request.useThumbnails || !ThumbnailCache::load(request.path, request.maxWidth, request.maxHeight, request.format, result.pixels, result.width, result.height, result.format))
+		{
+			const ResourceData data = request.rm->getFileData(request.path);
+			result.pixels.clear();
+			if(data.length != 0)
+				ImageIO::loadFromMemoryRGBA32(data.ptr.get(), data.length, result.pixels, result.width, result.height, request.maxWidth, request.maxHeight);
+
+			//compressing is slow too, so it's done here and not on the main thread
+			if(!result.pixels.empty())
+				result.format = TextureFormat::convert(result.pixels, result.width, result.height, request.format);
+
+			if(request.useThumbnails && !result.pixels.empty())
+				ThumbnailCache::save(request.path, request.maxWidth, request.maxHeight, request.format, result.pixels, result.width, result.height, result.format);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mDecoding--;
+			mResults.push_back(Result());
+			mResults.back().texture = result.texture;
+			mResults.back().pixels.swap(result.pixels);
+			mResults.back().width = result.width;
+			mResults.back().height = result.height;
+			mResults.back().format = result.format;
+		}
+
+		//wake up the main loop in case it's waiting for input
+		SDL_Event event;
+		event.type = SDL_USEREVENT;
+		event.user.code = SDL_USEREVENT_TEXTURELOADED;
+		event.user.data1 = NULL;
+		event.user.data2 = NULL;
+		SDL_PushEvent(&event);
+	}
+}
+
+void TextureLoader::processUploads(int budgetMs)
+{
+	const Uint32 start = SDL_GetTicks();
+
+	while(true)
+	{
+		Result result;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if(mResults.empty())
+				return;
+
+			result.texture = mResults.front().texture;
+			result.pixels.swap(mResults.front().pixels);
+			result.width = mResults.front().width;
+			result.height = mResults.front().height;
+			result.format = mResults.front().format;
+			mResults.pop_front();
+		}
+
+		std::shared_ptr<TextureResource> texture = result.texture.lock();
+		if(texture)
+		{
+			texture->finishLoading(result.pixels, result.width, result.height, result.format);
+			TextureCache::getInstance()->touch(texture);
+		}
+
+		//the pixels are on the GPU now, the buffer can take the next image
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if(mFreeBuffers.size() < TEXTURE_LOADER_MAX_BUFFERS)
+			{
+				mFreeBuffers.push_back(std::vector<unsigned char>());
+				mFreeBuffers.back().swap(result.pixels);
+			}
+		}
+
+		if((int)(SDL_GetTicks() - start) >= budgetMs)
+			return;
+	}
+}
+
+unsigned int TextureLoader::getPendingCount()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mRequests.size() + mDecoding + mResults.size();
+}
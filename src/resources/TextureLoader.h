@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <SDL.h>
+#include "TextureFormat.h"
+
+class ResourceManager;
+class TextureResource;
+
+#define TEXTURE_UPLOAD_BUDGET_MS 4 //time per frame the main thread may spend uploading finished textures (at least one is always uploaded)
+#define TEXTURE_LOADER_MAX_BUFFERS 4 //pixel buffers kept for reuse after their image was uploaded
+
+//Decodes images on worker threads so the main thread doesn't stall on FreeImage.
+//Finished images are handed back to their TextureResource in processUploads(), which has to be called on the main thread
+//(GL calls) once per frame - Window::update does this.
+//When an image finishes while the main loop waits for input, an SDL_USEREVENT with code SDL_USEREVENT_TEXTURELOADED wakes it up.
+class TextureLoader
+{
+public:
+	static TextureLoader* getInstance();
+
+	static const int SDL_USEREVENT_TEXTURELOADED = SDL_USEREVENT + 200; //This event is issued when a worker finished decoding an image.
+
+	//Queues texture for decoding. Only a weak reference is kept, textures that are gone by the time a worker gets to them are skipped.
+	void load(const std::shared_ptr<TextureResource>& texture, const ResourceManager& rm);
+
+	//Uploads finished images until budgetMs milliseconds have passed. Main thread only.
+	void processUploads(int budgetMs = TEXTURE_UPLOAD_BUDGET_MS);
+
+	//Number of textures waiting to be decoded or uploaded.
+	unsigned int getPendingCount();
+
+	//Stops the worker threads. Pending requests are dropped.
+	void shutdown();
+
+private:
+	TextureLoader();
+	~TextureLoader();
+
+	struct Request
+	{
+		std::weak_ptr<TextureResource> texture;
+		std::string path;
+		size_t maxWidth;
+		size_t maxHeight;
+		TextureFormat::Format format;
+		bool useThumbnails; //read from and write to the ThumbnailCache
+		const ResourceManager* rm;
+	};
+
+	struct Result
+	{
+		std::weak_ptr<TextureResource> texture;
+		std::vector<unsigned char> pixels;
+		size_t width;
+		size_t height;
+		TextureFormat::Format format;
+	};
+
+	void workerLoop();
+
+	std::vector<std::thread> mWorkers;
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	std::deque<Request> mRequests;
+	std::deque<Result> mResults;
+	std::vector< std::vector<unsigned char> > mFreeBuffers; //uploaded images' pixel buffers, decoded into again so workers don't allocate for every image
+	unsigned int mDecoding;
+	bool mStopping;
+
+	static TextureLoader* sInstance;
+};
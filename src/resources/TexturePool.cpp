@@ -0,0 +1,179 @@
+#include "TexturePool.h"
+#include "../Log.h"
+#include "../Renderer.h"
+#include "../GLExtensions.h"
+#include "../MemoryStats.h"
+#include <cstring>
+#include <iterator>
+
+TexturePool* TexturePool::sInstance = NULL;
+
+TexturePool* TexturePool::getInstance()
+{
+	if(sInstance == NULL)
+		sInstance = new TexturePool();
+
+	return sInstance;
+}
+
+TexturePool::TexturePool() : mReuses(0), mAllocations(0)
+{
+}
+
+Eigen::Vector2i TexturePool::getSizeClass(size_t width, size_t height)
+{
+	return Eigen::Vector2i((int)((width + TEXTURE_POOL_SIZE_STEP - 1) / TEXTURE_POOL_SIZE_STEP * TEXTURE_POOL_SIZE_STEP),
+		(int)((height + TEXTURE_POOL_SIZE_STEP - 1) / TEXTURE_POOL_SIZE_STEP * TEXTURE_POOL_SIZE_STEP));
+}
+
+GLuint TexturePool::acquire(const unsigned char* pixels, size_t width, size_t height, TextureFormat::Format format, bool mipmaps)
+{
+	Entry entry;
+	entry.size = getSizeClass(width, height);
+	entry.format = format;
+	entry.mipmaps = mipmaps;
+
+	GLuint texture = 0;
+	for(auto it = mFree.rbegin(); it != mFree.rend(); it++)
+	{
+		if(it->second.size == entry.size && it->second.format == format && it->second.mipmaps == mipmaps)
+		{
+			texture = it->first;
+			MemoryStats::remove(MemoryStats::CATEGORY_TEXTURES, getBytes(it->second));
+			mFree.erase(std::next(it).base());
+			mReuses++;
+			break;
+		}
+	}
+
+	if(texture == 0)
+	{
+		texture = create(entry);
+		mAllocations++;
+	}else{
+		Renderer::bindTexture(texture);
+	}
+
+	upload(pixels, width, height, entry);
+	if(mipmaps)
+		GLExtensions::updateMipmaps();
+
+	mUsed[texture] = entry;
+	return texture;
+}
+
+size_t TexturePool::getBytes(const Entry& entry)
+{
+	const size_t bytes = TextureFormat::getDataSize(entry.format, entry.size.x(), entry.size.y());
+	return entry.mipmaps ? bytes + bytes / 3 : bytes;
+}
+
+GLuint TexturePool::create(const Entry& entry)
+{
+	GLuint texture;
+	glGenTextures(1, &texture);
+	Renderer::bindTexture(texture);
+
+	//every upload into level 0 has to update the smaller levels too (GLES 2 does that in updateMipmaps(), called by acquire())
+	if(entry.mipmaps)
+		GLExtensions::enableMipmapGeneration();
+
+	TextureFormat::upload(entry.format, entry.size.x(), entry.size.y(), NULL);
+
+	//same filtering as TextureResource uses
+#ifdef USE_OPENGL_ES
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, entry.mipmaps ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR);
+#else
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, entry.mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+#endif
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	return texture;
+}
+
+void TexturePool::upload(const unsigned char* pixels, size_t width, size_t height, const Entry& entry)
+{
+	const size_t storageWidth = entry.size.x();
+	const size_t storageHeight = entry.size.y();
+	if(width == storageWidth && height == storageHeight)
+	{
+		TextureFormat::uploadSubImage(entry.format, width, height, pixels);
+		return;
+	}
+
+	//the unused part of the texture repeats the image's last row and column. filtering (and the smaller mipmap levels) at the
+	//image's edges would pick up whatever the previous image left there otherwise.
+	//uploading the padded image in one go regenerates the mipmaps only once.
+	const size_t pixelSize = TextureFormat::getPixelSize(entry.format);
+	const size_t rowSize = width * pixelSize;
+	const size_t storageRowSize = storageWidth * pixelSize;
+	mStaging.resize(storageRowSize * storageHeight);
+
+	for(size_t y = 0; y < height; y++)
+	{
+		unsigned char* row = mStaging.data() + y * storageRowSize;
+		memcpy(row, pixels + y * rowSize, rowSize);
+
+		const unsigned char* last = row + rowSize - pixelSize;
+		for(unsigned char* p = row + rowSize; p < row + storageRowSize; p += pixelSize)
+			memcpy(p, last, pixelSize);
+	}
+
+	for(size_t y = height; y < storageHeight; y++)
+		memcpy(mStaging.data() + y * storageRowSize, mStaging.data() + (height - 1) * storageRowSize, storageRowSize);
+
+	TextureFormat::uploadSubImage(entry.format, storageWidth, storageHeight, mStaging.data());
+}
+
+void TexturePool::release(GLuint texture)
+{
+	auto it = mUsed.find(texture);
+	if(it == mUsed.end())
+	{
+		LOG(LogError) << "Tried to release texture " << texture << ", which isn't from the texture pool!";
+		return;
+	}
+
+	//the TextureResource stopped counting it, but it's still allocated
+	MemoryStats::add(MemoryStats::CATEGORY_TEXTURES, getBytes(it->second));
+	mFree.push_back(std::make_pair(texture, it->second));
+	mUsed.erase(it);
+
+	if(mFree.size() > TEXTURE_POOL_MAX_FREE)
+	{
+		Renderer::deleteTexture(mFree.front().first);
+		MemoryStats::remove(MemoryStats::CATEGORY_TEXTURES, getBytes(mFree.front().second));
+		mFree.erase(mFree.begin());
+	}
+}
+
+void TexturePool::clear()
+{
+	for(unsigned int i = 0; i < mFree.size(); i++)
+	{
+		Renderer::deleteTexture(mFree.at(i).first);
+		MemoryStats::remove(MemoryStats::CATEGORY_TEXTURES, getBytes(mFree.at(i).second));
+	}
+	mFree.clear();
+
+	//the staging buffer is only needed while scrolling through games
+	std::vector<unsigned char>().swap(mStaging);
+}
+
+unsigned int TexturePool::getReuseCount() const
+{
+	return mReuses;
+}
+
+unsigned int TexturePool::getAllocationCount() const
+{
+	return mAllocations;
+}
+
+void TexturePool::logStats() const
+{
+	LOG(LogInfo) << "Texture pool: " << mAllocations << " textures allocated, " << mReuses << " reused, " << mFree.size() << " free, " << mUsed.size() << " in use.";
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <cstddef>
+#include <Eigen/Dense>
+#include "../platform.h"
+#include GLHEADER
+#include "TextureFormat.h"
+
+#define TEXTURE_POOL_SIZE_STEP 64 //pooled textures are rounded up to multiples of this, so similar images can share storage
+#define TEXTURE_POOL_MAX_FREE 6 //unused textures kept around for reuse, the rest are deleted
+
+//Recycles the GL textures of artwork (game screenshots), which come and go all the time while scrolling through a game list.
+//Instead of deleting a texture and allocating a new one for the next image, textures are rounded up to a size class and kept
+//when their image goes away. The next image of the same class, format and mipmapping is then uploaded into the existing storage
+//with glTexSubImage2D. Images only cover the bottom left part of their texture (see TextureResource::getTextureRect()).
+//Pooled textures clamp to their edges and can't be tiled. ETC1 textures can't be updated in place and aren't pooled.
+//Free textures don't count against the TextureCache budget, there are only a few of them.
+class TexturePool
+{
+public:
+	static TexturePool* getInstance();
+
+	//The size of the texture an image of width x height is stored in.
+	static Eigen::Vector2i getSizeClass(size_t width, size_t height);
+
+	//Returns a texture of getSizeClass(width, height) containing pixels, reusing a free one if possible. It's left bound.
+	GLuint acquire(const unsigned char* pixels, size_t width, size_t height, TextureFormat::Format format, bool mipmaps);
+
+	//Hands texture (which has to come from acquire()) back for reuse. Deletes it if there are enough free textures already.
+	void release(GLuint texture);
+
+	//Deletes all free textures. Call before the GL context goes away.
+	void clear();
+
+	unsigned int getReuseCount() const;
+	unsigned int getAllocationCount() const;
+	void logStats() const;
+
+private:
+	TexturePool();
+
+	struct Entry
+	{
+		Eigen::Vector2i size;
+		TextureFormat::Format format;
+		bool mipmaps;
+	};
+
+	static size_t getBytes(const Entry& entry); //GL storage of a texture, including its mipmaps
+
+	GLuint create(const Entry& entry);
+	void upload(const unsigned char* pixels, size_t width, size_t height, const Entry& entry);
+
+	std::vector< std::pair<GLuint, Entry> > mFree; //most recently released last
+	std::map<GLuint, Entry> mUsed;
+	std::vector<unsigned char> mStaging; //images padded to their size class
+	unsigned int mReuses;
+	unsigned int mAllocations;
+
+	static TexturePool* sInstance;
+};
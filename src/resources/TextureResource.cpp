@@ -4,12 +4,25 @@
 #include GLHEADER
 #include "../ImageIO.h"
 #include "../Renderer.h"
+#include "TextureLoader.h"
+#include "TextureCache.h"
+#include "TexturePool.h"
+#include "../GLExtensions.h"
+#include "../Settings.h"
+#include "../MemoryStats.h"
+#include <sstream>
 
 std::map< std::string, std::weak_ptr<TextureResource> > TextureResource::sTextureMap;
 
-TextureResource::TextureResource(const ResourceManager& rm, const std::string& path) : mTextureID(0), mPath(path), mTextureSize(Eigen::Vector2i::Zero())
+TextureResource::TextureResource(const ResourceManager& rm, const std::string& path, bool async, const Eigen::Vector2i& maxSize, TextureFormat::Format format) : mTextureID(0), mFramebufferID(0), mTextureBytes(0), mPath(path), mTextureSize(Eigen::Vector2i::Zero()), mStorageSize(Eigen::Vector2i::Zero()), mLoading(async), mPooled(false), mMaxSize(maxSize), mFormat(format)
+{
+	//async textures are queued by getAsync() once there's a shared_ptr to hand to the loader
+	if(!async)
+		reload(rm);
+}
+
+TextureResource::TextureResource(const std::shared_ptr<TextureAtlas>& atlas, const std::string& path) : mTextureID(0), mFramebufferID(0), mTextureBytes(0), mPath(path), mTextureSize(atlas->getImageSize(path)), mStorageSize(mTextureSize), mLoading(false), mPooled(false), mMaxSize(Eigen::Vector2i::Zero()), mFormat(TextureFormat::RGBA8888), mAtlas(atlas)
 {
-	reload(rm);
 }
 
 TextureResource::~TextureResource()
@@ -24,7 +37,8 @@ void TextureResource::unload(const ResourceManager& rm)
 
 void TextureResource::reload(const ResourceManager& rm)
 {
-	if(!mPath.empty())
+	//atlas pages are reloaded by the atlas itself, and textures that are still being decoded get uploaded when they're done
+	if(!mPath.empty() && !mAtlas && !mLoading)
 		initFromResource(rm.getFileData(mPath));
 }
 
@@ -34,7 +48,7 @@ void TextureResource::initFromResource(const ResourceData data)
 	deinit();
 
 	size_t width, height;
-	std::vector<unsigned char> imageRGBA = ImageIO::loadFromMemoryRGBA32(const_cast<unsigned char*>(data.ptr.get()), data.length, width, height);
+	std::vector<unsigned char> imageRGBA = ImageIO::loadFromMemoryRGBA32(const_cast<unsigned char*>(data.ptr.get()), data.length, width, height, mMaxSize.x(), mMaxSize.y());
 
 	if(imageRGBA.size() == 0)
 	{
@@ -42,19 +56,99 @@ void TextureResource::initFromResource(const ResourceData data)
 		return;
 	}
 
+	const TextureFormat::Format format = TextureFormat::convert(imageRGBA, width, height, mFormat);
+	initFromPixels(imageRGBA.data(), width, height, format);
+}
+
+void TextureResource::initFromPixels(const unsigned char* pixels, size_t width, size_t height, TextureFormat::Format format)
+{
+	const bool wantMipmaps = format != TextureFormat::ETC1 && Settings::getInstance()->getBool("Mipmaps");
+
+	//artwork is replaced all the time, so its textures are recycled (ETC1 can't be updated in place)
+	if(mMaxSize != Eigen::Vector2i::Zero() && format != TextureFormat::ETC1)
+	{
+		mStorageSize = TexturePool::getSizeClass(width, height);
+		const bool mipmaps = wantMipmaps && canMipmap(mStorageSize.x(), mStorageSize.y());
+		mTextureID = TexturePool::getInstance()->acquire(pixels, width, height, format, mipmaps);
+		mPooled = true;
+
+		mTextureBytes = TextureFormat::getDataSize(format, mStorageSize.x(), mStorageSize.y());
+		if(mipmaps)
+			mTextureBytes += mTextureBytes / 3;
+		TextureCache::getInstance()->addBytes(mTextureBytes);
+		MemoryStats::add(MemoryStats::CATEGORY_TEXTURES, mTextureBytes);
+
+		mTextureSize << width, height;
+		return;
+	}
+
 	//now for the openGL texture stuff
 	glGenTextures(1, &mTextureID);
-	glBindTexture(GL_TEXTURE_2D, mTextureID);
+	Renderer::bindTexture(mTextureID);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageRGBA.data());
+	//let GL build the mipmaps while uploading, so downscaled images don't shimmer (not possible for compressed textures)
+	const bool mipmaps = wantMipmaps && canMipmap(width, height);
+	if(mipmaps)
+		GLExtensions::enableMipmapGeneration();
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	TextureFormat::upload(format, width, height, pixels);
+	if(mipmaps)
+		GLExtensions::updateMipmaps();
+	mTextureBytes = TextureFormat::getDataSize(format, width, height);
+	if(mipmaps)
+		mTextureBytes += mTextureBytes / 3; //all the smaller levels together take up a third of the full size
+
+	TextureCache::getInstance()->addBytes(mTextureBytes);
+	MemoryStats::add(MemoryStats::CATEGORY_TEXTURES, mTextureBytes);
+
+#ifdef USE_OPENGL_ES
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR); //trilinear filtering is too slow for the Pi
+#else
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+#endif
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	//only tiled images need to repeat, and GLES without OES_texture_npot doesn't draw non power of two textures that repeat at all
+	const GLint wrap = canRepeat(width, height) ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
 
 	mTextureSize << width, height;
+	mStorageSize = mTextureSize;
+}
+
+static bool isPowerOfTwo(size_t value)
+{
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+bool TextureResource::canMipmap(size_t width, size_t height)
+{
+	return (isPowerOfTwo(width) && isPowerOfTwo(height)) || GLExtensions::hasNPOTMipmaps();
+}
+
+bool TextureResource::canRepeat(size_t width, size_t height)
+{
+	//the same full NPOT support that allows mipmaps allows GL_REPEAT
+	return canMipmap(width, height);
+}
+
+void TextureResource::finishLoading(const std::vector<unsigned char>& pixels, size_t width, size_t height, TextureFormat::Format format)
+{
+	//someone needed the texture right away and loaded it synchronously
+	if(!mLoading)
+		return;
+
+	mLoading = false;
+	deinit();
+
+	if(pixels.size() == 0)
+	{
+		LOG(LogError) << "Could not initialize texture \"" << mPath << "\" (invalid resource data)!";
+		return;
+	}
+
+	initFromPixels(pixels.data(), width, height, format);
 }
 
 void TextureResource::initFromScreen()
@@ -65,26 +159,95 @@ void TextureResource::initFromScreen()
 	int height = Renderer::getScreenHeight();
 
 	glGenTextures(1, &mTextureID);
-	glBindTexture(GL_TEXTURE_2D, mTextureID);
+	Renderer::bindTexture(mTextureID);
 
 	glCopyTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 0, 0, width, height, 0);
+	mTextureBytes = width * height * 3;
+	TextureCache::getInstance()->addBytes(mTextureBytes);
+	MemoryStats::add(MemoryStats::CATEGORY_TEXTURES, mTextureBytes);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	//the screen is never tiled, and usually not a power of two
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-	mTextureSize[0] = height;
+	mTextureSize[0] = width;
 	mTextureSize[1] = height;
+	mStorageSize = mTextureSize;
+}
+
+bool TextureResource::initAsRenderTarget(int width, int height)
+{
+	if(!GLExtensions::hasFramebuffers())
+		return false;
+
+	//already set up (textures lose their framebuffer when the renderer is reinitialized)
+	if(mFramebufferID != 0 && mTextureSize == Eigen::Vector2i(width, height))
+		return true;
+
+	deinit();
+
+	glGenTextures(1, &mTextureID);
+	Renderer::bindTexture(mTextureID);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+	mTextureBytes = width * height * 3;
+	TextureCache::getInstance()->addBytes(mTextureBytes);
+	MemoryStats::add(MemoryStats::CATEGORY_TEXTURES, mTextureBytes);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	//render targets don't have to be a power of two, but then they can't repeat on GLES
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	mTextureSize << width, height;
+	mStorageSize = mTextureSize;
+
+	glGenFramebuffers(1, &mFramebufferID);
+	glBindFramebuffer(GL_FRAMEBUFFER, mFramebufferID);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTextureID, 0);
+	const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if(status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		LOG(LogError) << "Could not create render target (framebuffer status 0x" << std::hex << status << ")!";
+		deinit();
+		return false;
+	}
+
+	return true;
+}
+
+GLuint TextureResource::getFramebufferID() const
+{
+	return mFramebufferID;
 }
 
 void TextureResource::deinit()
 {
 	if(mTextureID != 0)
 	{
-		glDeleteTextures(1, &mTextureID);
+		if(mPooled)
+			TexturePool::getInstance()->release(mTextureID);
+		else
+			Renderer::deleteTexture(mTextureID);
 		mTextureID = 0;
+		mPooled = false;
+
+		TextureCache::getInstance()->removeBytes(mTextureBytes);
+		MemoryStats::remove(MemoryStats::CATEGORY_TEXTURES, mTextureBytes);
+		mTextureBytes = 0;
+	}
+
+	if(mFramebufferID != 0)
+	{
+		glDeleteFramebuffers(1, &mFramebufferID);
+		mFramebufferID = 0;
 	}
 }
 
@@ -93,16 +256,47 @@ Eigen::Vector2i TextureResource::getSize() const
 	return mTextureSize;
 }
 
+bool TextureResource::isLoading() const
+{
+	return mLoading;
+}
+
+const std::string& TextureResource::getPath() const
+{
+	return mPath;
+}
+
 void TextureResource::bind() const
 {
-	if(mTextureID != 0)
-		glBindTexture(GL_TEXTURE_2D, mTextureID);
+	GLuint textureID = getTextureID();
+	if(textureID != 0)
+		Renderer::bindTexture(textureID);
 	else
 		LOG(LogError) << "Tried to bind uninitialized texture!";
 }
 
+GLuint TextureResource::getTextureID() const
+{
+	if(mAtlas)
+		return mAtlas->getTextureID(mPath);
+
+	return mTextureID;
+}
+
+Eigen::Vector4f TextureResource::getTextureRect() const
+{
+	if(mAtlas)
+		return mAtlas->getTextureRect(mPath);
+
+	//pooled textures can be bigger than their image
+	if(mStorageSize != mTextureSize && mStorageSize.x() != 0 && mStorageSize.y() != 0)
+		return Eigen::Vector4f(0, 0, (float)mTextureSize.x() / mStorageSize.x(), (float)mTextureSize.y() / mStorageSize.y());
+
+	return Eigen::Vector4f(0, 0, 1, 1);
+}
+
 
-std::shared_ptr<TextureResource> TextureResource::get(ResourceManager& rm, const std::string& path)
+std::shared_ptr<TextureResource> TextureResource::get(ResourceManager& rm, const std::string& path, bool allowAtlas)
 {
 	if(path.empty())
 	{
@@ -111,17 +305,77 @@ std::shared_ptr<TextureResource> TextureResource::get(ResourceManager& rm, const
 		return tex;
 	}
 
+	//atlas images don't own any GL resources, so they aren't cached
+	if(allowAtlas)
+	{
+		std::shared_ptr<TextureAtlas> atlas = TextureAtlas::find(path);
+		if(atlas)
+			return std::shared_ptr<TextureResource>(new TextureResource(atlas, path));
+	}
+
 	auto foundTexture = sTextureMap.find(path);
 	if(foundTexture != sTextureMap.end())
 	{
 		if(!foundTexture->second.expired())
 		{
-			return foundTexture->second.lock();
+			std::shared_ptr<TextureResource> tex = foundTexture->second.lock();
+
+			//still in the loader's queue, but we can't wait for it
+			if(tex->mLoading)
+			{
+				tex->mLoading = false;
+				tex->reload(rm);
+			}
+
+			TextureCache::getInstance()->recordHit();
+			TextureCache::getInstance()->touch(tex);
+			return tex;
 		}
 	}
 
+	TextureCache::getInstance()->recordMiss();
+
 	std::shared_ptr<TextureResource> tex = std::shared_ptr<TextureResource>(new TextureResource(rm, path));
 	sTextureMap[path] = std::weak_ptr<TextureResource>(tex);
 	rm.addReloadable(tex);
+	TextureCache::getInstance()->touch(tex);
+	return tex;
+}
+
+std::shared_ptr<TextureResource> TextureResource::getAsync(ResourceManager& rm, const std::string& path, const Eigen::Vector2i& maxSize)
+{
+	if(path.empty())
+		return get(rm, path);
+
+	std::shared_ptr<TextureAtlas> atlas = TextureAtlas::find(path);
+	if(atlas)
+		return std::shared_ptr<TextureResource>(new TextureResource(atlas, path));
+
+	//scaled down versions are different textures
+	std::string key = path;
+	if(maxSize != Eigen::Vector2i::Zero())
+	{
+		std::stringstream ss;
+		ss << path << "@" << maxSize.x() << "x" << maxSize.y();
+		key = ss.str();
+	}
+
+	auto foundTexture = sTextureMap.find(key);
+	if(foundTexture != sTextureMap.end() && !foundTexture->second.expired())
+	{
+		std::shared_ptr<TextureResource> tex = foundTexture->second.lock();
+		TextureCache::getInstance()->recordHit();
+		if(!tex->mLoading)
+			TextureCache::getInstance()->touch(tex);
+		return tex;
+	}
+
+	TextureCache::getInstance()->recordMiss();
+
+	//not cached until the loader is done, so loads nobody wants anymore can still be skipped
+	std::shared_ptr<TextureResource> tex = std::shared_ptr<TextureResource>(new TextureResource(rm, path, true, maxSize, TextureFormat::getArtworkFormat()));
+	sTextureMap[key] = std::weak_ptr<TextureResource>(tex);
+	rm.addReloadable(tex);
+	TextureLoader::getInstance()->load(tex, rm);
 	return tex;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ResourceManager.h"
+#include "TextureAtlas.h"
+#include "TextureFormat.h"
 
 #include <string>
 #include <Eigen/Dense>
@@ -10,7 +12,15 @@
 class TextureResource : public IReloadable
 {
 public:
-	static std::shared_ptr<TextureResource> get(ResourceManager& rm, const std::string& path);
+	//If allowAtlas is true and the image was packed into a live TextureAtlas, the result refers to the image's part of an atlas page.
+	//Pass false for images that will be tiled.
+	static std::shared_ptr<TextureResource> get(ResourceManager& rm, const std::string& path, bool allowAtlas = true);
+
+	//Like get(), but a texture that isn't loaded yet is decoded in the background by the TextureLoader.
+	//Until isLoading() returns false the texture has no size and nothing to draw.
+	//If maxSize is nonzero, larger images are scaled down while decoding, as far as they still cover it (0 leaves that axis unconstrained).
+	//Textures loaded this way are artwork and are stored in TextureFormat::getArtworkFormat().
+	static std::shared_ptr<TextureResource> getAsync(ResourceManager& rm, const std::string& path, const Eigen::Vector2i& maxSize = Eigen::Vector2i::Zero());
 
 	virtual ~TextureResource();
 
@@ -18,20 +28,50 @@ public:
 	void reload(const ResourceManager& rm) override;
 	
 	Eigen::Vector2i getSize() const;
+	bool isLoading() const;
+	const std::string& getPath() const;
 	void bind() const;
+	GLuint getTextureID() const;
+
+	//The part of the texture this resource covers in texture coordinates (x1, y1, x2, y2).
+	//All of it (0, 0, 1, 1), except for images in an atlas and artwork in a pooled texture that's bigger than the image (see TexturePool).
+	Eigen::Vector4f getTextureRect() const;
 	
 	void initFromScreen();
 
+	//Turns this into an empty width x height texture that can be drawn into (see Renderer::bindRenderTarget()). Does nothing if it
+	//already is one of that size, so it can be reused. Returns false if framebuffer objects aren't supported.
+	bool initAsRenderTarget(int width, int height);
+	GLuint getFramebufferID() const;
+
 private:
-	TextureResource(const ResourceManager& rm, const std::string& path);
+	friend class TextureLoader;
+
+	TextureResource(const ResourceManager& rm, const std::string& path, bool async = false, const Eigen::Vector2i& maxSize = Eigen::Vector2i::Zero(),
+		TextureFormat::Format format = TextureFormat::RGBA8888);
+	TextureResource(const std::shared_ptr<TextureAtlas>& atlas, const std::string& path);
 
 	void initFromPath();
 	void initFromResource(const ResourceData data);
+	void initFromPixels(const unsigned char* pixels, size_t width, size_t height, TextureFormat::Format format);
+	void finishLoading(const std::vector<unsigned char>& pixels, size_t width, size_t height, TextureFormat::Format format); //called by the TextureLoader on the main thread
 	void deinit();
 
+	static bool canMipmap(size_t width, size_t height);
+	static bool canRepeat(size_t width, size_t height); //GL_REPEAT wrapping, for tiled images
+
 	Eigen::Vector2i mTextureSize;
+	Eigen::Vector2i mStorageSize; //size of the GL texture, bigger than mTextureSize for pooled textures
 	GLuint mTextureID;
+	GLuint mFramebufferID; //only for render targets
+	size_t mTextureBytes; //counted against the TextureCache budget
 	const std::string mPath;
+	bool mLoading; //decoding in the background, see getAsync()
+	bool mPooled; //mTextureID belongs to the TexturePool
+	const Eigen::Vector2i mMaxSize; //images are scaled down towards this while decoding, zero means native size
+	const TextureFormat::Format mFormat; //format to convert to after decoding, images with transparency might end up in a different one
+
+	std::shared_ptr<TextureAtlas> mAtlas; //if set, the texture belongs to the atlas and mTextureID is unused
 
 	static std::map< std::string, std::weak_ptr<TextureResource> > sTextureMap;
 };
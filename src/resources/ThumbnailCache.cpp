@@ -0,0 +1,180 @@
+#include "ThumbnailCache.h"
+#include "../platform.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <thread>
+#include <cstring>
+#include <stdint.h>
+
+#ifndef WIN32
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+#define THUMBNAIL_MAGIC 0x33545345 //"EST3"
+
+//a cache file is this header, followed by the source path (pathLength chars) and the pixels (TextureFormat::getDataSize() bytes)
+struct ThumbnailHeader
+{
+	uint32_t magic;
+	uint32_t width;
+	uint32_t height;
+	uint32_t pathLength;
+	uint32_t format; //TextureFormat::Format the pixels are in
+	uint32_t padding;
+	int64_t sourceTime;
+	uint64_t sourceSize;
+};
+
+std::string ThumbnailCache::getCacheDirectory()
+{
+	return getHomePath() + "/.emulationstation/thumbnails";
+}
+
+std::string ThumbnailCache::getEntryPath(const std::string& path, size_t maxWidth, size_t maxHeight, TextureFormat::Format requestedFormat)
+{
+	std::stringstream key;
+	key << path << "@" << maxWidth << "x" << maxHeight << "#" << requestedFormat;
+
+	//collisions are caught by comparing the path stored in the entry
+	std::stringstream ss;
+	ss << getCacheDirectory() << "/" << std::hex << std::hash<std::string>()(key.str()) << ".raw";
+	return ss.str();
+}
+
+//checks the header and stored path against the source file, returns the number of bytes in front of the pixels (0 if the entry is stale)
+static size_t validateEntry(const unsigned char* data, size_t size, const std::string& path, int64_t sourceTime, uint64_t sourceSize)
+{
+	if(size < sizeof(ThumbnailHeader))
+		return 0;
+
+	ThumbnailHeader header;
+	memcpy(&header, data, sizeof(ThumbnailHeader));
+
+	const size_t offset = sizeof(ThumbnailHeader) + header.pathLength;
+	if(header.magic != THUMBNAIL_MAGIC || header.sourceTime != sourceTime || header.sourceSize != sourceSize || header.format > TextureFormat::ETC1
+		|| header.pathLength != path.length() || size != offset + TextureFormat::getDataSize((TextureFormat::Format)header.format, header.width, header.height)
+		|| memcmp(data + sizeof(ThumbnailHeader), path.c_str(), path.length()) != 0)
+		return 0;
+
+	return offset;
+}
+
+bool ThumbnailCache::load(const std::string& path, size_t maxWidth, size_t maxHeight, TextureFormat::Format requestedFormat,
+	std::vector<unsigned char>& pixels, size_t& width, size_t& height, TextureFormat::Format& format)
+{
+	boost::system::error_code ec;
+	const int64_t sourceTime = fs::last_write_time(path, ec);
+	if(ec)
+		return false;
+	const uint64_t sourceSize = fs::file_size(path, ec);
+	if(ec)
+		return false;
+
+	const std::string entryPath = getEntryPath(path, maxWidth, maxHeight, requestedFormat);
+	bool found = false;
+
+#ifndef WIN32
+	int fd = open(entryPath.c_str(), O_RDONLY);
+	if(fd < 0)
+		return false;
+
+	struct stat info;
+	if(fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		const size_t size = (size_t)info.st_size;
+		void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(mapping != MAP_FAILED)
+		{
+			const unsigned char* data = (const unsigned char*)mapping;
+			const size_t offset = validateEntry(data, size, path, sourceTime, sourceSize);
+			if(offset != 0)
+			{
+				ThumbnailHeader header;
+				memcpy(&header, data, sizeof(ThumbnailHeader));
+				width = header.width;
+				height = header.height;
+				format = (TextureFormat::Format)header.format;
+				pixels.assign(data + offset, data + size);
+				found = true;
+			}
+			munmap(mapping, size);
+		}
+	}
+	close(fd);
+#else
+	std::ifstream stream(entryPath.c_str(), std::ios::binary);
+	if(!stream)
+		return false;
+
+	std::vector<unsigned char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	const size_t offset = validateEntry(data.data(), data.size(), path, sourceTime, sourceSize);
+	if(offset != 0)
+	{
+		ThumbnailHeader header;
+		memcpy(&header, data.data(), sizeof(ThumbnailHeader));
+		width = header.width;
+		height = header.height;
+		format = (TextureFormat::Format)header.format;
+		pixels.assign(data.begin() + offset, data.end());
+		found = true;
+	}
+#endif
+
+	return found;
+}
+
+void ThumbnailCache::save(const std::string& path, size_t maxWidth, size_t maxHeight, TextureFormat::Format requestedFormat,
+	const std::vector<unsigned char>& pixels, size_t width, size_t height, TextureFormat::Format format)
+{
+	if(pixels.size() != TextureFormat::getDataSize(format, width, height))
+		return;
+
+	boost::system::error_code ec;
+	ThumbnailHeader header;
+	header.magic = THUMBNAIL_MAGIC;
+	header.width = (uint32_t)width;
+	header.height = (uint32_t)height;
+	header.pathLength = (uint32_t)path.length();
+	header.format = (uint32_t)format;
+	header.padding = 0;
+	header.sourceTime = fs::last_write_time(path, ec);
+	if(ec)
+		return;
+	header.sourceSize = fs::file_size(path, ec);
+	if(ec)
+		return;
+
+	fs::create_directories(getCacheDirectory(), ec);
+
+	//write to a temporary file first, so a crash or a second worker never leaves a half written entry behind
+	const std::string entryPath = getEntryPath(path, maxWidth, maxHeight, requestedFormat);
+	std::stringstream tempPath;
+	tempPath << entryPath << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+
+	{
+		std::ofstream stream(tempPath.str().c_str(), std::ios::binary | std::ios::trunc);
+		if(!stream)
+			return;
+
+		stream.write((const char*)&header, sizeof(ThumbnailHeader));
+		stream.write(path.c_str(), path.length());
+		stream.write((const char*)pixels.data(), pixels.size());
+		if(!stream)
+		{
+			stream.close();
+			fs::remove(tempPath.str(), ec);
+			return;
+		}
+	}
+
+	fs::rename(tempPath.str(), entryPath, ec);
+	if(ec)
+		fs::remove(tempPath.str(), ec);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "TextureFormat.h"
+
+//Keeps scaled down copies of images (game screenshots) in ~/.emulationstation/thumbnails/ as raw pixels, ready to be uploaded.
+//Entries are keyed by source path, size and requested TextureFormat and remember the source's modification time and file size, so changed images are decoded again.
+//Loading an entry is an mmap and a copy instead of a PNG/JPEG decode. Used by the TextureLoader's worker threads, so everything here is thread safe.
+class ThumbnailCache
+{
+public:
+	//Fills pixels, width, height and format (the one they're actually in) from the cache entry for path scaled to maxWidth x maxHeight
+	//and converted to requestedFormat. Returns false if there is no up to date entry.
+	static bool load(const std::string& path, size_t maxWidth, size_t maxHeight, TextureFormat::Format requestedFormat,
+		std::vector<unsigned char>& pixels, size_t& width, size_t& height, TextureFormat::Format& format);
+
+	//Stores the result of decoding path at maxWidth x maxHeight and converting it to requestedFormat. Failing to write just means we decode again next time.
+	static void save(const std::string& path, size_t maxWidth, size_t maxHeight, TextureFormat::Format requestedFormat,
+		const std::vector<unsigned char>& pixels, size_t width, size_t height, TextureFormat::Format format);
+
+	static std::string getCacheDirectory();
+
+private:
+	static std::string getEntryPath(const std::string& path, size_t maxWidth, size_t maxHeight, TextureFormat::Format requestedFormat);
+};